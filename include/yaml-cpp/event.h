@@ -0,0 +1,49 @@
+#ifndef EVENT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <string>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+struct EventType {
+  enum value {
+    DocumentStart,
+    DocumentEnd,
+    Null,
+    Alias,
+    Scalar,
+    SequenceStart,
+    SequenceEnd,
+    MapStart,
+    MapEnd
+  };
+};
+
+// One parse event, as pulled by Parser::NextEvent; the fields are those of
+// the matching EventHandler call, and the others are left empty. Reusing the
+// same Event for every call reuses the storage of its strings.
+struct Event {
+  Event()
+      : type(EventType::DocumentEnd),
+        anchor(NullAnchor),
+        style(EmitterStyle::Default) {}
+
+  EventType::value type;
+  Mark mark;
+  std::string tag;
+  anchor_t anchor;  // for Alias, the anchor it refers to
+  std::string value;
+  EmitterStyle::value style;
+};
+}
+
+#endif  // EVENT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -11,11 +11,14 @@
 
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/vieweventhandler.h"
 
 namespace YAML {
 struct Mark;
 
-class EventHandler {
+// Adapts ViewEventHandler to callbacks that take std::strings. The parser
+// hands out views of std::strings, so this doesn't copy them.
+class EventHandler : public ViewEventHandler {
  public:
   virtual ~EventHandler() {}
 
@@ -34,6 +37,24 @@ class EventHandler {
   virtual void OnMapStart(const Mark& mark, const std::string& tag,
                           anchor_t anchor, EmitterStyle::value style) = 0;
   virtual void OnMapEnd() = 0;
+
+  virtual void OnScalarView(const Mark& mark, const StringView& tag,
+                            anchor_t anchor, const StringView& value) {
+    OnScalar(mark, tag.str(m_tagBuffer), anchor, value.str(m_valueBuffer));
+  }
+  virtual void OnSequenceStartView(const Mark& mark, const StringView& tag,
+                                   anchor_t anchor,
+                                   EmitterStyle::value style) {
+    OnSequenceStart(mark, tag.str(m_tagBuffer), anchor, style);
+  }
+  virtual void OnMapStartView(const Mark& mark, const StringView& tag,
+                              anchor_t anchor, EmitterStyle::value style) {
+    OnMapStart(mark, tag.str(m_tagBuffer), anchor, style);
+  }
+
+ private:
+  // for views that aren't of a whole std::string
+  std::string m_tagBuffer, m_valueBuffer;
 };
 }
 
@@ -0,0 +1,113 @@
+#ifndef EVENTTAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENTTAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/vieweventhandler.h"
+
+namespace YAML {
+// Records the events it's handed, so that they can be handed to other
+// handlers later, as often as needed, without parsing the text again. The
+// events are kept in one array, with all scalars in one string and each tag
+// stored once.
+//
+//   EventTape tape;
+//   while (parser.HandleNextDocument(tape)) {}
+//   tape.Replay(validator);
+//   tape.Replay(converter);
+class YAML_CPP_API EventTape : public ViewEventHandler {
+ public:
+  EventTape();
+  virtual ~EventTape();
+
+  // Replay
+  // . Hands every recorded event to 'eventHandler', in order; scalars are
+  //   passed as views into the tape.
+  // . Returns false if the handler stopped parsing before the end.
+  // . Collections nested more than 'maxDepth' deep are a ParserException,
+  //   as Parser::SetMaxDepth makes them; 0 means no limit.
+  bool Replay(ViewEventHandler& eventHandler, std::size_t maxDepth = 0) const;
+
+  // Save
+  // . Writes the tape as one block of bytes that Restore can take back as
+  //   is: a header, the events, the scalars and the tags. The layout is that
+  //   of this build's memory, so it's only meant to be read back by the
+  //   same library on the same kind of machine; the same tape always gives
+  //   the same bytes.
+  void Save(std::ostream& out) const;
+
+  // Restore
+  // . Replaces the tape with one written by Save, e.g. from a mapped file.
+  // . Returns false (and leaves the tape empty) if the data isn't a whole,
+  //   well-formed tape of this layout.
+  bool Restore(const char* data, std::size_t size);
+
+  // the number of events recorded
+  std::size_t size() const { return m_events.size(); }
+  bool empty() const { return m_events.empty(); }
+  void clear();
+
+  virtual void OnDocumentStart(const Mark& mark);
+  virtual void OnDocumentEnd();
+
+  virtual void OnNull(const Mark& mark, anchor_t anchor);
+  virtual void OnAlias(const Mark& mark, anchor_t anchor);
+  // a scalar over 4 GiB is a std::length_error
+  virtual void OnScalarView(const Mark& mark, const StringView& tag,
+                            anchor_t anchor, const StringView& value);
+
+  virtual void OnSequenceStartView(const Mark& mark, const StringView& tag,
+                                   anchor_t anchor, EmitterStyle::value style);
+  virtual void OnSequenceEnd();
+
+  virtual void OnMapStartView(const Mark& mark, const StringView& tag,
+                              anchor_t anchor, EmitterStyle::value style);
+  virtual void OnMapEnd();
+
+ private:
+  // 28 bytes, with no padding, so that Save writes every byte it sets. A
+  // scalar's offset in m_scalars isn't kept: they are stored in the order
+  // of their events, so Replay adds up the sizes as it goes.
+  struct Entry {
+    Mark mark;
+    unsigned char type;    // an EventType
+    unsigned char style;   // an EmitterStyle
+    std::uint16_t unused;  // always 0
+    std::uint32_t tag;     // in m_tags
+    std::uint32_t anchor;
+    std::uint32_t size;  // of the scalar
+  };
+
+  void Add(unsigned char type, const Mark& mark, anchor_t anchor = NullAnchor,
+           std::uint32_t tag = 0, EmitterStyle::value style =
+                                      EmitterStyle::Default);
+  std::uint32_t TagId(const StringView& tag);
+  bool Check() const;
+
+ private:
+  std::vector<Entry> m_events;
+  std::string m_scalars;
+
+  std::vector<std::string> m_tags;
+  typedef std::unordered_map<std::string, std::uint32_t> TagIds;
+  TagIds m_tagIds;
+  std::string m_tagKey;  // reused to look them up
+};
+}
+
+#endif  // EVENTTAPE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -65,6 +65,7 @@ const char* const CHAR_IN_BLOCK = "unexpected character in block scalar";
 const char* const AMBIGUOUS_ANCHOR =
     "cannot assign the same alias to multiple nodes";
 const char* const UNKNOWN_ANCHOR = "the referenced anchor is not defined";
+const char* const NESTING_TOO_DEEP = "collections are nested too deeply";
 
 const char* const INVALID_NODE =
     "invalid node; this may result from using a map iterator as a sequence "
@@ -76,6 +77,7 @@ const char* const BAD_DEREFERENCE = "bad dereference";
 const char* const BAD_SUBSCRIPT = "operator[] call on a scalar";
 const char* const BAD_PUSHBACK = "appending to a non-sequence";
 const char* const BAD_INSERT = "inserting in a non-convertible-to-map";
+const char* const FROZEN_NODE = "modifying a frozen node";
 
 const char* const UNMATCHED_GROUP_TAG = "unmatched group tag";
 const char* const UNEXPECTED_END_SEQ = "unexpected end sequence token";
@@ -216,6 +218,12 @@ class BadInsert : public RepresentationException {
       : RepresentationException(Mark::null_mark(), ErrorMsg::BAD_INSERT) {}
 };
 
+class FrozenNode : public RepresentationException {
+ public:
+  FrozenNode()
+      : RepresentationException(Mark::null_mark(), ErrorMsg::FROZEN_NODE) {}
+};
+
 class EmitterException : public Exception {
  public:
   EmitterException(const std::string& msg_)
@@ -0,0 +1,63 @@
+#ifndef NODE_COMPARE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_COMPARE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/node.h"
+
+namespace YAML {
+// Equals
+// . Whether two nodes have the same content (see Hash), where == only tells
+//   whether they are the same node. Subtrees whose hashes differ are told
+//   apart without being walked.
+YAML_CPP_API bool Equals(const Node& lhs, const Node& rhs);
+
+// Hash
+// . A hash of a node's content: its type, its tag (unless it is
+//   non-specific, as a plain scalar's "?" is) and its scalar or elements, a
+//   map's in any order. Sequences and maps cache theirs until some node that
+//   was hashed changes, or for good once they are frozen.
+YAML_CPP_API std::size_t Hash(const Node& node);
+
+struct ChangeType {
+  enum value { Added, Removed, Changed };
+};
+
+// NodeChange
+// . One difference found by Diff, at 'path': the keys (or, in sequences,
+//   the indices) that lead to it from the root.
+struct NodeChange {
+  ChangeType::value type;
+  std::vector<Node> path;
+  Node from;  // undefined if added
+  Node to;    // undefined if removed
+};
+
+// Diff
+// . The changes that turn 'from' into 'to': map entries by key, and
+//   sequence elements by index (past the end of the shorter one, added or
+//   removed). Sequences and maps are only listed as changed when their type
+//   or tag is; otherwise the changes inside them are.
+// . Subtrees with the same hash are taken to be equal, and skipped.
+YAML_CPP_API std::vector<NodeChange> Diff(const Node& from, const Node& to);
+}
+
+namespace std {
+template <>
+struct hash<YAML::Node> {
+  std::size_t operator()(const YAML::Node& node) const {
+    return YAML::Hash(node);
+  }
+};
+}
+
+#endif  // NODE_COMPARE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -10,6 +10,7 @@
 #include "yaml-cpp/node/detail/node.h"
 #include "yaml-cpp/node/detail/node_data.h"
 #include <type_traits>
+#include <utility>
 
 namespace YAML {
 namespace detail {
@@ -73,6 +74,8 @@ inline bool node::equals(const char* rhs, shared_memory_holder pMemory) {
 template <typename Key>
 inline node* node_data::get(const Key& key,
                             shared_memory_holder pMemory) const {
+  if (node* pSource = shared_elements())
+    return static_cast<const node&>(*pSource).get(key, pMemory);
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -80,15 +83,20 @@ inline node* node_data::get(const Key& key,
     case NodeType::Null:
       return NULL;
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory))
+      if (node* pNode = get_idx<Key>::get(sequence(), key, pMemory))
         return pNode;
       return NULL;
     case NodeType::Scalar:
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
+  std::size_t pos;
+  if (find_indexed(key, pos))
+    return pos < entries().size() ? entries()[pos].second : NULL;
+
+  for (node_map::const_iterator it = entries().begin(); it != entries().end();
+       ++it) {
+    if (it->first && it->first->equals(key, pMemory)) {
       return it->second;
     }
   }
@@ -98,26 +106,47 @@ inline node* node_data::get(const Key& key,
 
 template <typename Key>
 inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
+  check_mutable();
   switch (m_type) {
     case NodeType::Map:
       break;
     case NodeType::Undefined:
     case NodeType::Null:
-    case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory)) {
-        m_type = NodeType::Sequence;
+    case NodeType::Sequence: {
+      // a null node only has storage for a sequence if it becomes one
+      node_seq empty;
+      node_seq& seq = m_type == NodeType::Sequence ? sequence() : empty;
+      const std::size_t size = seq.size();
+      if (node* pNode = get_idx<Key>::get(seq, key, pMemory)) {
+        if (seq.size() != size) {
+          changed();
+          pNode->add_owner(*this);
+        }
+        if (m_type != NodeType::Sequence) {
+          reset_sequence();
+          sequence().swap(empty);
+          m_type = NodeType::Sequence;
+        }
         return *pNode;
       }
 
       convert_to_map(pMemory);
       break;
+    }
     case NodeType::Scalar:
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      return *it->second;
+  std::size_t pos;
+  if (find_indexed(key, pos)) {
+    if (pos < entries().size())
+      return *entries()[pos].second;
+  } else {
+    for (node_map::const_iterator it = entries().begin();
+         it != entries().end(); ++it) {
+      if (it->first && it->first->equals(key, pMemory)) {
+        return *it->second;
+      }
     }
   }
 
@@ -129,12 +158,21 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
 
 template <typename Key>
 inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
+  check_mutable();
   if (m_type != NodeType::Map)
     return false;
 
-  for (node_map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      m_map.erase(it);
+  std::size_t pos;
+  if (find_indexed(key, pos)) {
+    if (pos == entries().size())
+      return false;
+    erase_pair(pos);
+    return true;
+  }
+
+  for (std::size_t i = 0; i < entries().size(); i++) {
+    if (entries()[i].first && entries()[i].first->equals(key, pMemory)) {
+      erase_pair(i);
       return true;
     }
   }
@@ -144,8 +182,9 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
 
 // map
 template <typename Key, typename Value>
-inline void node_data::force_insert(const Key& key, const Value& value,
+inline void node_data::force_insert(Key&& key, Value&& value,
                                     shared_memory_holder pMemory) {
+  check_mutable();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -158,11 +197,27 @@ inline void node_data::force_insert(const Key& key, const Value& value,
       throw BadInsert();
   }
 
-  node& k = convert_to_node(key, pMemory);
-  node& v = convert_to_node(value, pMemory);
+  node& k = convert_to_node(std::forward<Key>(key), pMemory);
+  node& v = convert_to_node(std::forward<Value>(value), pMemory);
   insert_map_pair(k, v);
 }
 
+// emplace
+// . Like force_insert, but only if there's nothing at the key yet (as a
+//   const lookup finds it); returns whether the pair was inserted.
+template <typename Key, typename Value>
+inline bool node_data::emplace(Key&& key, Value&& value,
+                               shared_memory_holder pMemory) {
+  check_mutable();
+  if (m_type == NodeType::Scalar)
+    throw BadInsert();
+  if (static_cast<const node_data&>(*this).get(key, pMemory))
+    return false;
+
+  force_insert(std::forward<Key>(key), std::forward<Value>(value), pMemory);
+  return true;
+}
+
 template <typename T>
 inline node& node_data::convert_to_node(const T& rhs,
                                         shared_memory_holder pMemory) {
@@ -7,7 +7,9 @@
 #pragma once
 #endif
 
-#include <set>
+#include <list>
+#include <string>
+#include <unordered_set>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/ptr.h"
@@ -15,27 +17,96 @@
 namespace YAML {
 namespace detail {
 class node;
+class node_arena;
 }  // namespace detail
 }  // namespace YAML
 
 namespace YAML {
 namespace detail {
+// string_pool
+// . Owns one copy of each distinct string handed to intern(); the returned
+//   references stay valid for the lifetime of the pool.
+class YAML_CPP_API string_pool {
+ public:
+  const std::string& intern(const std::string& value) {
+    return *m_strings.insert(value).first;
+  }
+  std::size_t size() const { return m_strings.size(); }
+
+ private:
+  std::unordered_set<std::string> m_strings;
+};
+
+// memory
+// . Owns the nodes of a document, and of every document merged into it.
+// . Merging moves the other memory's storage over in constant time, and
+//   leaves that memory forwarding to this one (see memory_holder), so that
+//   the holders still pointing to it keep it all alive.
 class YAML_CPP_API memory {
  public:
   node& create_node();
-  void merge(const memory& rhs);
+  const std::string& intern(const std::string& value);
+  void merge(memory& rhs);
+
+  // collect
+  // . Frees the nodes that 'root' can't reach, and returns how many there
+  //   were; any other handle to them is left dangling. Interned strings are
+  //   kept.
+  std::size_t collect(node& root);
+
+  // keep
+  // . Keeps 'pMemory' alive as long as this memory, without merging it, for
+  //   nodes that share its (frozen) nodes; see node_data::share.
+  void keep(const shared_memory& pMemory);
 
  private:
-  typedef std::set<shared_node> Nodes;
-  Nodes m_nodes;
+  friend class memory_holder;
+
+  // Nodes are bump-allocated (with their refs and data) and freed together
+  // with the arena, or by collect; arenas picked up from merged memory are
+  // kept the same way as their string pools, until collect empties them.
+  typedef std::shared_ptr<node_arena> shared_node_arena;
+  typedef std::list<shared_node_arena> Arenas;
+  shared_node_arena m_pNodes;
+  Arenas m_mergedNodes;
+
+  // interned scalars; pools picked up from merged memory are kept alive since
+  // their nodes still point into them
+  typedef std::list<shared_string_pool> Pools;
+  shared_string_pool m_pStrings;
+  Pools m_mergedStrings;
+
+  // memory kept alive by keep, and by the memory merged into this
+  typedef std::list<shared_memory> Memories;
+  Memories m_kept;
+
+  // the memory this one was merged into, if any
+  shared_memory m_pForward;
 };
 
 class YAML_CPP_API memory_holder {
  public:
   memory_holder() : m_pMemory(new memory) {}
 
-  node& create_node() { return m_pMemory->create_node(); }
+  node& create_node() { return get().create_node(); }
+  const std::string& intern(const std::string& value) {
+    return get().intern(value);
+  }
   void merge(memory_holder& rhs);
+  std::size_t collect(node& root) { return get().collect(root); }
+  void keep(const memory_holder& rhs);
+
+ private:
+  // get
+  // . The memory that now holds our nodes: a merged one forwards to the one
+  //   it was merged into, which we skip to from then on.
+  memory& get() {
+    while (m_pMemory->m_pForward) {
+      shared_memory pForward = m_pMemory->m_pForward;
+      m_pMemory = pForward;
+    }
+    return *m_pMemory;
+  }
 
  private:
   shared_memory m_pMemory;
@@ -12,18 +12,23 @@
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/detail/node_ref.h"
-#include <set>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace YAML {
 namespace detail {
+// Nodes, with their refs and data, are only made by memory::create_node and
+// live as long as that memory; see node_arena.
 class node {
  public:
-  node() : m_pRef(new node_ref) {}
+  explicit node(node_ref& ref) : m_pRef(&ref) {}
   node(const node&) = delete;
   node& operator=(const node&) = delete;
 
   bool is(const node& rhs) const { return m_pRef == rhs.m_pRef; }
-  const node_ref* ref() const { return m_pRef.get(); }
+  const node_ref* ref() const { return m_pRef; }
 
   bool is_defined() const { return m_pRef->is_defined(); }
   const Mark& mark() const { return m_pRef->mark(); }
@@ -42,22 +47,54 @@ class node {
       return;
 
     m_pRef->mark_defined();
-    for (nodes::iterator it = m_dependencies.begin();
-         it != m_dependencies.end(); ++it)
-      (*it)->mark_defined();
-    m_dependencies.clear();
+    if (m_pDependencies) {
+      std::unique_ptr<nodes> dependencies(std::move(m_pDependencies));
+      for (nodes::iterator it = dependencies->begin();
+           it != dependencies->end(); ++it)
+        (*it)->child_defined();
+    }
+  }
+
+  // child_defined
+  // . One of this node's elements has been defined, so it is too, and its
+  //   size may have grown.
+  void child_defined() {
+    mark_defined();
+    m_pRef->update_size();
   }
 
   void add_dependency(node& rhs) {
-    if (is_defined())
+    if (is_defined()) {
       rhs.mark_defined();
-    else
-      m_dependencies.insert(&rhs);
+      return;
+    }
+
+    if (!m_pDependencies)
+      m_pDependencies.reset(new nodes);
+    if (std::find(m_pDependencies->begin(), m_pDependencies->end(), &rhs) ==
+        m_pDependencies->end())
+      m_pDependencies->push_back(&rhs);
+  }
+
+  // drop_dependencies
+  // . Forgets the nodes waiting on this one for which 'dropped' is true
+  //   (see memory::collect).
+  template <typename Pred>
+  void drop_dependencies(Pred dropped) {
+    if (!m_pDependencies)
+      return;
+    m_pDependencies->erase(std::remove_if(m_pDependencies->begin(),
+                                          m_pDependencies->end(), dropped),
+                           m_pDependencies->end());
+    if (m_pDependencies->empty())
+      m_pDependencies.reset();
   }
 
   void set_ref(const node& rhs) {
+    m_pRef->check_mutable();
     if (rhs.is_defined())
       mark_defined();
+    m_pRef->replaced_by(*rhs.m_pRef);
     m_pRef = rhs.m_pRef;
   }
   void set_data(const node& rhs) {
@@ -67,6 +104,38 @@ class node {
   }
 
   void set_mark(const Mark& mark) { m_pRef->set_mark(mark); }
+  bool is_key() const { return m_pRef->is_key(); }
+  void mark_key() { m_pRef->mark_key(); }
+  void add_owner(node_data& owner) { m_pRef->add_owner(owner); }
+
+  // freeze
+  // . Freezes this node and every node under it (see node_data::freeze),
+  //   one at a time, so deep documents don't use up the call stack.
+  void freeze() {
+    std::vector<node*> nodes(1, this);
+    while (!nodes.empty()) {
+      node* pNode = nodes.back();
+      nodes.pop_back();
+      pNode->m_pRef->freeze(nodes);
+    }
+  }
+  bool is_frozen() const { return m_pRef->is_frozen(); }
+  std::size_t hash() const { return m_pRef->hash(); }
+
+  // share, unshare
+  // . See node_data::share. Anything that hands out or changes this node's
+  //   elements unshares it first.
+  void share(node& source) { m_pRef->share(source); }
+  void unshare(shared_memory_holder pMemory) {
+    if (!m_pRef->is_shared())
+      return;
+
+    std::vector<node*> undefined;
+    m_pRef->unshare(pMemory, undefined);
+    for (std::vector<node*>::iterator it = undefined.begin();
+         it != undefined.end(); ++it)
+      (*it)->add_dependency(*this);
+  }
 
   void set_type(NodeType::value type) {
     if (type != NodeType::Undefined)
@@ -81,10 +150,22 @@ class node {
     mark_defined();
     m_pRef->set_scalar(scalar);
   }
+  void set_scalar(std::string&& scalar) {
+    mark_defined();
+    m_pRef->set_scalar(std::move(scalar));
+  }
+  void set_interned_scalar(const std::string& scalar) {
+    mark_defined();
+    m_pRef->set_interned_scalar(scalar);
+  }
   void set_tag(const std::string& tag) {
     mark_defined();
     m_pRef->set_tag(tag);
   }
+  void set_interned_tag(const std::string& tag) {
+    mark_defined();
+    m_pRef->set_interned_tag(tag);
+  }
 
   // style
   void set_style(EmitterStyle::value style) {
@@ -107,15 +188,35 @@ class node {
 
   // sequence
   void push_back(node& node, shared_memory_holder pMemory) {
+    unshare(pMemory);
     m_pRef->push_back(node, pMemory);
     node.add_dependency(*this);
   }
   void insert(node& key, node& value, shared_memory_holder pMemory) {
+    unshare(pMemory);
     m_pRef->insert(key, value, pMemory);
     key.add_dependency(*this);
     value.add_dependency(*this);
   }
 
+  // push_back_defined, insert_defined
+  // . The same, for elements that are already defined (as NodeBuilder's
+  //   are), so this node doesn't need to hear from them.
+  void push_back_defined(node& node, shared_memory_holder pMemory) {
+    m_pRef->push_back(node, pMemory);
+  }
+  void insert_defined(node& key, node& value, shared_memory_holder pMemory) {
+    m_pRef->insert(key, value, pMemory);
+  }
+
+  // append
+  // . Adds the elements of 'rhs', which has this node's type, after this
+  //   node's; see node_data::append.
+  void append(const node& rhs, shared_memory_holder pMemory) {
+    unshare(pMemory);
+    m_pRef->append(*rhs.m_pRef);
+  }
+
   // indexing
   template <typename Key>
   node* get(const Key& key, shared_memory_holder pMemory) const {
@@ -126,12 +227,14 @@ class node {
   }
   template <typename Key>
   node& get(const Key& key, shared_memory_holder pMemory) {
+    unshare(pMemory);
     node& value = m_pRef->get(key, pMemory);
     value.add_dependency(*this);
     return value;
   }
   template <typename Key>
   bool remove(const Key& key, shared_memory_holder pMemory) {
+    unshare(pMemory);
     return m_pRef->remove(key, pMemory);
   }
 
@@ -142,26 +245,38 @@ class node {
     return static_cast<const node_ref&>(*m_pRef).get(key, pMemory);
   }
   node& get(node& key, shared_memory_holder pMemory) {
+    unshare(pMemory);
     node& value = m_pRef->get(key, pMemory);
     key.add_dependency(*this);
     value.add_dependency(*this);
     return value;
   }
   bool remove(node& key, shared_memory_holder pMemory) {
+    unshare(pMemory);
     return m_pRef->remove(key, pMemory);
   }
 
   // map
   template <typename Key, typename Value>
-  void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory) {
-    m_pRef->force_insert(key, value, pMemory);
+  void force_insert(Key&& key, Value&& value, shared_memory_holder pMemory) {
+    unshare(pMemory);
+    m_pRef->force_insert(std::forward<Key>(key), std::forward<Value>(value),
+                         pMemory);
+  }
+  template <typename Key, typename Value>
+  bool emplace(Key&& key, Value&& value, shared_memory_holder pMemory) {
+    unshare(pMemory);
+    return m_pRef->emplace(std::forward<Key>(key), std::forward<Value>(value),
+                           pMemory);
   }
 
  private:
-  shared_node_ref m_pRef;
-  typedef std::set<node*> nodes;
-  nodes m_dependencies;
+  node_ref* m_pRef;
+
+  // the nodes waiting on this one to be defined; only undefined nodes have
+  // any, so the list is made on the first
+  typedef std::vector<node*> nodes;
+  std::unique_ptr<nodes> m_pDependencies;
 };
 }
 }
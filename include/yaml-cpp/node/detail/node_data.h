@@ -7,8 +7,11 @@
 #pragma once
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <list>
-#include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +33,7 @@ namespace detail {
 class YAML_CPP_API node_data {
  public:
   node_data();
+  ~node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
 
@@ -37,8 +41,11 @@ class YAML_CPP_API node_data {
   void set_mark(const Mark& mark);
   void set_type(NodeType::value type);
   void set_tag(const std::string& tag);
+  void set_interned_tag(const std::string& tag);
   void set_null();
   void set_scalar(const std::string& scalar);
+  void set_scalar(std::string&& scalar);
+  void set_interned_scalar(const std::string& scalar);
   void set_style(EmitterStyle::value style);
 
   bool is_defined() const { return m_isDefined; }
@@ -46,12 +53,17 @@ class YAML_CPP_API node_data {
   NodeType::value type() const {
     return m_isDefined ? m_type : NodeType::Undefined;
   }
-  const std::string& scalar() const { return m_scalar; }
-  const std::string& tag() const { return m_tag; }
-  EmitterStyle::value style() const { return m_style; }
+  const std::string& scalar() const {
+    return m_pScalar ? *m_pScalar : empty_scalar;
+  }
+  const std::string& tag() const { return m_pTag ? *m_pTag : empty_scalar; }
+  EmitterStyle::value style() const {
+    return static_cast<EmitterStyle::value>(m_style);
+  }
 
   // size/iterator
   std::size_t size() const;
+  void update_size();
 
   const_node_iterator begin() const;
   node_iterator begin();
@@ -63,6 +75,12 @@ class YAML_CPP_API node_data {
   void push_back(node& node, shared_memory_holder pMemory);
   void insert(node& key, node& value, shared_memory_holder pMemory);
 
+  // append
+  // . Adds the elements of 'rhs', a sequence or map of this node's type that
+  //   has elements of its own, after this node's, as they are: none of the
+  //   keys of 'rhs' may be a key of this map already.
+  void append(const node_data& rhs);
+
   // indexing
   template <typename Key>
   node* get(const Key& key, shared_memory_holder pMemory) const;
@@ -77,50 +95,225 @@ class YAML_CPP_API node_data {
 
   // map
   template <typename Key, typename Value>
-  void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory);
+  void force_insert(Key&& key, Value&& value, shared_memory_holder pMemory);
+  template <typename Key, typename Value>
+  bool emplace(Key&& key, Value&& value, shared_memory_holder pMemory);
+
+  // freeze
+  // . Makes this node read-only, and adds the nodes it holds to 'nodes' to be
+  //   frozen in turn; anything that would change it throws FrozenNode. Its
+  //   key index is built now, since a const lookup must not build one.
+  void freeze(std::vector<node*>& nodes);
+
+  // push_children
+  // . Adds the nodes this one holds (a map's keys and values) to 'nodes'.
+  void push_children(std::vector<node*>& nodes) const;
+
+  // share
+  // . Makes this (new) node a copy of the frozen node 'source' that still
+  //   reads its elements from there; see CloneShared.
+  // . unshare gives it elements of its own, copies of the source's that are
+  //   shared the same way, before they are handed out or changed; it adds
+  //   the undefined ones to 'undefined', to depend on this node.
+  void share(node& source);
+  bool is_shared() const { return m_storage == SharedStorage; }
+  void unshare(shared_memory_holder pMemory, std::vector<node*>& undefined);
+  bool is_frozen() const { return m_isFrozen; }
+  void check_mutable() const {
+    if (m_isFrozen)
+      throw_frozen();
+  }
+
+  // keys of maps; see find_key
+  bool is_key() const { return m_isKey; }
+  void mark_key() { m_isKey = true; }
+  void key_changed();
+
+  // owners
+  // . An element is linked back to the sequences and maps it is inserted
+  //   in: changed tells them (and theirs, up the tree) to drop their cached
+  //   hash, and key_changed tells a key's maps to drop their key index. A
+  //   link is kept until memory::collect finds its owner gone, so a node may
+  //   still be linked to one it has left; that only costs the owner a hash
+  //   or an index made again.
+  // . replaced_by hands this node's links to 'rhs', which takes its place
+  //   in whatever holds it (see node::set_ref).
+  void add_owner(node_data& owner);
+  template <typename Pred>
+  void drop_owners(Pred dropped) {
+    m_owners.remove_if(dropped);
+  }
+  void replaced_by(node_data& rhs);
+
+  // hash
+  // . A hash of the node's content: its type, its tag (unless it is
+  //   non-specific) and its scalar or elements, a map's in any order. A
+  //   sequence's or map's elements' hash is cached until it, or a node under
+  //   it, changes (see changed); once it is frozen, for good.
+  std::size_t hash() const;
+  static bool is_nonspecific(const std::string& tag) {
+    return tag.empty() || tag == "?" || tag == "!";
+  }
 
  public:
   static std::string empty_scalar;
 
  private:
-  void compute_seq_size() const;
-  void compute_map_size() const;
+  typedef std::vector<node*> node_seq;
+  typedef std::pair<node*, node*> kv_pair;
+  typedef std::vector<kv_pair> node_map;
+  typedef std::list<kv_pair> kv_pairs;
+
+  // positions of the scalar keys by their text, built when a big map is
+  // first looked up
+  struct key_index;
+
+  // the nodes this one is linked back to (see add_owner): most have one, so
+  // it is held inline, and only more need a vector
+  class owner_list {
+   public:
+    owner_list() : m_pOwner(NULL) {}
+    ~owner_list();
+    owner_list(const owner_list&) = delete;
+    owner_list& operator=(const owner_list&) = delete;
+
+    node_data* const* begin() const;
+    node_data* const* end() const;
+    void push_back(node_data* pOwner);
+    template <typename Pred>
+    void remove_if(Pred pred);
+
+   private:
+    typedef std::vector<node_data*> owners;
+
+    // m_pOwner holds the vector instead, with its low bit set
+    owners* many() const {
+      const std::uintptr_t bits = reinterpret_cast<std::uintptr_t>(m_pOwner);
+      return bits & 1 ? reinterpret_cast<owners*>(bits - 1) : NULL;
+    }
+
+    node_data* m_pOwner;
+  };
+
+  // a hash of the elements of a sequence or map; see hash
+  struct hash_cache {
+    hash_cache() : value(0) {}
+
+    std::atomic<std::size_t> value;  // 0 if there is none
+  };
+
+  // the elements of a sequence
+  struct sequence_data {
+    sequence_data() : definedSize(0) {}
+
+    node_seq nodes;
+    std::size_t definedSize;  // defined elements at the front; see update_size
+    hash_cache hash;
+  };
+
+  // the entries of a map, in the order they were inserted; a removed one
+  // leaves a null pair (see erase_pair)
+  struct map_data {
+    map_data();
+    ~map_data();
+
+    node_map entries;
+    std::size_t removed;  // null pairs in entries
+    kv_pairs undefinedPairs;
+    mutable std::unique_ptr<key_index> keyIndex;
+    hash_cache hash;
+  };
+
+  // what the node owns besides its fixed fields, which depends on its type;
+  // see set_storage
+  enum storage_type {
+    NoStorage,
+    ScalarStorage,
+    SequenceStorage,
+    MapStorage,
+    SharedStorage  // see share
+  };
+
+  static void throw_frozen();
+  void set_storage(storage_type storage);
+  node_seq& sequence() { return m_pSequence->nodes; }
+  const node_seq& sequence() const { return m_pSequence->nodes; }
+  node_map& entries() { return m_pMap->entries; }
+  const node_map& entries() const { return m_pMap->entries; }
+  node* shared_elements() const;
+  const node_data& shared_source() const;
+  std::size_t elements_hash() const;
+  bool drop_hash();
+  void changed();
+  void owners_changed();
 
   void reset_sequence();
   void reset_map();
 
   void insert_map_pair(node& key, node& value);
+  std::size_t find_entry(const node& key) const;
   void convert_to_map(shared_memory_holder pMemory);
   void convert_sequence_to_map(shared_memory_holder pMemory);
 
   template <typename T>
   static node& convert_to_node(const T& rhs, shared_memory_holder pMemory);
+  static node& convert_to_node(const std::string& rhs,
+                               shared_memory_holder pMemory);
+  static node& convert_to_node(std::string&& rhs, shared_memory_holder pMemory);
+
+  // find_indexed
+  // . For a string key, sets pos to the entry whose key it matches (or to
+  //   entries().size()) and returns true; other keys are compared one by one
+  //   with equals().
+  template <typename Key>
+  bool find_indexed(const Key& /* key */, std::size_t& /* pos */) const {
+    return false;
+  }
+  bool find_indexed(const std::string& key, std::size_t& pos) const {
+    pos = find_key(key);
+    return true;
+  }
+  std::size_t find_key(const std::string& key) const;
+  void index_keys() const;
+  void erase_pair(std::size_t pos);
+  void compact_map();
 
  private:
-  bool m_isDefined;
+  // Laid out to keep a node small: a document may have millions of them,
+  // and most are scalars, whose text (like the tags) the builder interns.
   Mark m_mark;
   NodeType::value m_type;
-  std::string m_tag;
-  EmitterStyle::value m_style;
-
-  // scalar
-  std::string m_scalar;
-
-  // sequence
-  typedef std::vector<node*> node_seq;
-  node_seq m_sequence;
-
-  mutable std::size_t m_seqSize;
+  unsigned char m_style;  // an EmitterStyle::value
+  bool m_isDefined;
+  bool m_isKey;  // of some map; changes to it call key_changed
+  bool m_ownsTag;
+  bool m_isFrozen;
+  unsigned char m_storage;  // a storage_type
 
-  // map
-  typedef std::map<node*, node*> node_map;
-  node_map m_map;
+  const std::string* m_pTag;     // interned, or owned if m_ownsTag
+  const std::string* m_pScalar;  // interned, or m_pOwnedScalar
+  owner_list m_owners;
 
-  typedef std::pair<node*, node*> kv_pair;
-  typedef std::list<kv_pair> kv_pairs;
-  mutable kv_pairs m_undefinedPairs;
+  // which of these is live is given by m_storage; a sequence or map always
+  // has its storage (or shares its source's), but others may keep whatever
+  // they had
+  union {
+    std::string* m_pOwnedScalar;
+    sequence_data* m_pSequence;
+    map_data* m_pMap;
+    node* m_pSource;
+  };
 };
+
+template <typename Pred>
+inline void node_data::owner_list::remove_if(Pred pred) {
+  if (owners* pOwners = many()) {
+    pOwners->erase(std::remove_if(pOwners->begin(), pOwners->end(), pred),
+                   pOwners->end());
+  } else if (m_pOwner && pred(m_pOwner)) {
+    m_pOwner = NULL;
+  }
+}
 }
 }
 
@@ -11,7 +11,6 @@
 #include "yaml-cpp/node/ptr.h"
 #include <iterator>
 #include <memory>
-#include <map>
 #include <utility>
 #include <vector>
 #include <cstddef>
@@ -37,7 +36,7 @@ struct node_iterator_value : public std::pair<V*, V*> {
 };
 
 typedef std::vector<node*> node_seq;
-typedef std::map<node*, node*> node_map;
+typedef std::vector<std::pair<node*, node*> > node_map;
 
 template <typename V>
 struct node_iterator_type {
@@ -161,8 +160,9 @@ class node_iterator_base
     return it;
   }
 
+  // a removed entry's slot is left null; see node_data::erase_pair
   bool is_defined(MapIter it) const {
-    return it->first->is_defined() && it->second->is_defined();
+    return it->first && it->first->is_defined() && it->second->is_defined();
   }
 
  private:
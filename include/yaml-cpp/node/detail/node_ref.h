@@ -11,15 +11,18 @@
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/detail/node_data.h"
+#include <utility>
 
 namespace YAML {
 namespace detail {
 class node_ref {
  public:
-  node_ref() : m_pData(new node_data) {}
+  explicit node_ref(node_data& data) : m_pData(&data) {}
   node_ref(const node_ref&) = delete;
   node_ref& operator=(const node_ref&) = delete;
 
+  const node_data* data() const { return m_pData; }
+
   bool is_defined() const { return m_pData->is_defined(); }
   const Mark& mark() const { return m_pData->mark(); }
   NodeType::value type() const { return m_pData->type(); }
@@ -28,17 +31,44 @@ class node_ref {
   EmitterStyle::value style() const { return m_pData->style(); }
 
   void mark_defined() { m_pData->mark_defined(); }
-  void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
+  bool is_key() const { return m_pData->is_key(); }
+  void mark_key() { m_pData->mark_key(); }
+  void add_owner(node_data& owner) { m_pData->add_owner(owner); }
+  void replaced_by(node_ref& rhs) { m_pData->replaced_by(*rhs.m_pData); }
+  void freeze(std::vector<node*>& nodes) { m_pData->freeze(nodes); }
+  bool is_frozen() const { return m_pData->is_frozen(); }
+  void check_mutable() const { m_pData->check_mutable(); }
+  std::size_t hash() const { return m_pData->hash(); }
+  void share(node& source) { m_pData->share(source); }
+  bool is_shared() const { return m_pData->is_shared(); }
+  void unshare(shared_memory_holder pMemory, std::vector<node*>& undefined) {
+    m_pData->unshare(pMemory, undefined);
+  }
+  void set_data(const node_ref& rhs) {
+    m_pData->check_mutable();
+    m_pData->replaced_by(*rhs.m_pData);
+    m_pData = rhs.m_pData;
+  }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
   void set_tag(const std::string& tag) { m_pData->set_tag(tag); }
+  void set_interned_tag(const std::string& tag) {
+    m_pData->set_interned_tag(tag);
+  }
   void set_null() { m_pData->set_null(); }
   void set_scalar(const std::string& scalar) { m_pData->set_scalar(scalar); }
+  void set_scalar(std::string&& scalar) {
+    m_pData->set_scalar(std::move(scalar));
+  }
+  void set_interned_scalar(const std::string& scalar) {
+    m_pData->set_interned_scalar(scalar);
+  }
   void set_style(EmitterStyle::value style) { m_pData->set_style(style); }
 
   // size/iterator
   std::size_t size() const { return m_pData->size(); }
+  void update_size() { m_pData->update_size(); }
 
   const_node_iterator begin() const {
     return static_cast<const node_data&>(*m_pData).begin();
@@ -57,6 +87,7 @@ class node_ref {
   void insert(node& key, node& value, shared_memory_holder pMemory) {
     m_pData->insert(key, value, pMemory);
   }
+  void append(const node_ref& rhs) { m_pData->append(*rhs.m_pData); }
 
   // indexing
   template <typename Key>
@@ -84,13 +115,18 @@ class node_ref {
 
   // map
   template <typename Key, typename Value>
-  void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory) {
-    m_pData->force_insert(key, value, pMemory);
+  void force_insert(Key&& key, Value&& value, shared_memory_holder pMemory) {
+    m_pData->force_insert(std::forward<Key>(key), std::forward<Value>(value),
+                          pMemory);
+  }
+  template <typename Key, typename Value>
+  bool emplace(Key&& key, Value&& value, shared_memory_holder pMemory) {
+    return m_pData->emplace(std::forward<Key>(key), std::forward<Value>(value),
+                            pMemory);
   }
 
  private:
-  shared_node_data m_pData;
+  node_data* m_pData;
 };
 }
 }
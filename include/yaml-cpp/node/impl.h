@@ -13,6 +13,7 @@
 #include "yaml-cpp/node/detail/node.h"
 #include "yaml-cpp/exceptions.h"
 #include <string>
+#include <utility>
 
 namespace YAML {
 inline Node::Node() : m_isValid(true), m_pNode(NULL) {}
@@ -42,6 +43,20 @@ inline Node::Node(const Node& rhs)
       m_pMemory(rhs.m_pMemory),
       m_pNode(rhs.m_pNode) {}
 
+inline Node::Node(Node&& rhs)
+    : m_isValid(rhs.m_isValid),
+      m_pMemory(std::move(rhs.m_pMemory)),
+      m_pNode(rhs.m_pNode) {
+  rhs.m_pNode = NULL;
+}
+
+inline Node::Node(std::string&& rhs)
+    : m_isValid(true),
+      m_pMemory(new detail::memory_holder),
+      m_pNode(&m_pMemory->create_node()) {
+  m_pNode->set_scalar(std::move(rhs));
+}
+
 inline Node::Node(Zombie) : m_isValid(false), m_pNode(NULL) {}
 
 inline Node::Node(detail::node& node, detail::shared_memory_holder pMemory)
@@ -247,6 +262,31 @@ inline Node& Node::operator=(const Node& rhs) {
   return *this;
 }
 
+inline Node& Node::operator=(Node&& rhs) {
+  if (!m_isValid || !rhs.m_isValid)
+    throw InvalidNode();
+  if (is(rhs))
+    return *this;
+  if (m_pNode) {
+    AssignNode(rhs);
+  } else {
+    rhs.EnsureNodeExists();
+    m_pMemory = std::move(rhs.m_pMemory);
+    m_pNode = rhs.m_pNode;
+  }
+  rhs.m_pMemory.reset();
+  rhs.m_pNode = NULL;
+  return *this;
+}
+
+inline Node& Node::operator=(std::string&& rhs) {
+  if (!m_isValid)
+    throw InvalidNode();
+  EnsureNodeExists();
+  m_pNode->set_scalar(std::move(rhs));
+  return *this;
+}
+
 inline void Node::AssignData(const Node& rhs) {
   if (!m_isValid || !rhs.m_isValid)
     throw InvalidNode();
@@ -283,26 +323,35 @@ inline std::size_t Node::size() const {
 inline const_iterator Node::begin() const {
   if (!m_isValid)
     return const_iterator();
-  return m_pNode ? const_iterator(m_pNode->begin(), m_pMemory)
-                 : const_iterator();
+  if (!m_pNode)
+    return const_iterator();
+  return const_iterator(m_pNode->begin(), m_pMemory);
 }
 
 inline iterator Node::begin() {
   if (!m_isValid)
     return iterator();
-  return m_pNode ? iterator(m_pNode->begin(), m_pMemory) : iterator();
+  if (!m_pNode)
+    return iterator();
+  m_pNode->unshare(m_pMemory);
+  return iterator(m_pNode->begin(), m_pMemory);
 }
 
 inline const_iterator Node::end() const {
   if (!m_isValid)
     return const_iterator();
-  return m_pNode ? const_iterator(m_pNode->end(), m_pMemory) : const_iterator();
+  if (!m_pNode)
+    return const_iterator();
+  return const_iterator(m_pNode->end(), m_pMemory);
 }
 
 inline iterator Node::end() {
   if (!m_isValid)
     return iterator();
-  return m_pNode ? iterator(m_pNode->end(), m_pMemory) : iterator();
+  if (!m_pNode)
+    return iterator();
+  m_pNode->unshare(m_pMemory);
+  return iterator(m_pNode->end(), m_pMemory);
 }
 
 // sequence
@@ -323,6 +372,25 @@ inline void Node::push_back(const Node& rhs) {
   m_pMemory->merge(*rhs.m_pMemory);
 }
 
+inline void Node::push_back(Node&& rhs) {
+  push_back(static_cast<const Node&>(rhs));
+  rhs.m_pMemory.reset();
+  rhs.m_pNode = NULL;
+}
+
+inline void Node::push_back(std::string&& rhs) {
+  if (!m_isValid)
+    throw InvalidNode();
+  EnsureNodeExists();
+  if (m_pNode->is_frozen())
+    throw FrozenNode();
+
+  // made in this node's memory, so there's nothing to merge
+  detail::node& value = m_pMemory->create_node();
+  value.set_scalar(std::move(rhs));
+  m_pNode->push_back(value, m_pMemory);
+}
+
 // helpers for indexing
 namespace detail {
 template <typename T>
@@ -366,6 +434,9 @@ template <typename T>
 inline typename to_value_t<T>::return_type to_value(const T& t) {
   return to_value_t<T>(t)();
 }
+
+// and passes an rvalue std::string on, so it can be moved
+inline std::string&& to_value(std::string&& t) { return std::move(t); }
 }
 
 // indexing
@@ -387,6 +458,8 @@ inline Node Node::operator[](const Key& key) {
   if (!m_isValid)
     throw InvalidNode();
   EnsureNodeExists();
+  if (m_pNode->is_frozen())
+    return static_cast<const Node&>(*this)[key];
   detail::node& value = m_pNode->get(detail::to_value(key), m_pMemory);
   return Node(value, m_pMemory);
 }
@@ -404,7 +477,8 @@ inline const Node Node::operator[](const Node& key) const {
     throw InvalidNode();
   EnsureNodeExists();
   key.EnsureNodeExists();
-  m_pMemory->merge(*key.m_pMemory);
+  if (!m_pNode->is_frozen())
+    m_pMemory->merge(*key.m_pMemory);
   detail::node* value =
       static_cast<const detail::node&>(*m_pNode).get(*key.m_pNode, m_pMemory);
   if (!value) {
@@ -417,6 +491,8 @@ inline Node Node::operator[](const Node& key) {
   if (!m_isValid || !key.m_isValid)
     throw InvalidNode();
   EnsureNodeExists();
+  if (m_pNode->is_frozen())
+    return static_cast<const Node&>(*this)[key];
   key.EnsureNodeExists();
   m_pMemory->merge(*key.m_pMemory);
   detail::node& value = m_pNode->get(*key.m_pNode, m_pMemory);
@@ -433,14 +509,44 @@ inline bool Node::remove(const Node& key) {
 
 // map
 template <typename Key, typename Value>
-inline void Node::force_insert(const Key& key, const Value& value) {
+inline void Node::force_insert(Key&& key, Value&& value) {
   if (!m_isValid)
     throw InvalidNode();
   EnsureNodeExists();
-  m_pNode->force_insert(detail::to_value(key), detail::to_value(value),
+  m_pNode->force_insert(detail::to_value(std::forward<Key>(key)),
+                        detail::to_value(std::forward<Value>(value)),
                         m_pMemory);
 }
 
+template <typename Key, typename Value>
+inline bool Node::emplace(Key&& key, Value&& value) {
+  if (!m_isValid)
+    throw InvalidNode();
+  EnsureNodeExists();
+  return m_pNode->emplace(detail::to_value(std::forward<Key>(key)),
+                          detail::to_value(std::forward<Value>(value)),
+                          m_pMemory);
+}
+
+inline void Node::Freeze() {
+  if (!m_isValid)
+    throw InvalidNode();
+  EnsureNodeExists();
+  m_pNode->freeze();
+}
+
+inline bool Node::IsFrozen() const {
+  return m_isValid && m_pNode && m_pNode->is_frozen();
+}
+
+inline std::size_t Node::CollectGarbage() {
+  if (!m_isValid)
+    throw InvalidNode();
+  if (!m_pNode || !m_pMemory)
+    return 0;
+  return m_pMemory->collect(*m_pNode);
+}
+
 // free functions
 inline bool operator==(const Node& lhs, const Node& rhs) { return lhs.is(rhs); }
 }
@@ -8,6 +8,7 @@
 #endif
 
 #include <stdexcept>
+#include <string>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/emitterstyle.h"
@@ -30,6 +31,7 @@ class YAML_CPP_API Node {
  public:
   friend class NodeBuilder;
   friend class NodeEvents;
+  friend class NodeView;
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
@@ -37,6 +39,9 @@ class YAML_CPP_API Node {
   friend class detail::iterator_base;
   template <typename T, typename S>
   friend struct as_if;
+  friend YAML_CPP_API Node CloneShared(const Node& node);
+  friend YAML_CPP_API bool Equals(const Node& lhs, const Node& rhs);
+  friend YAML_CPP_API std::size_t Hash(const Node& node);
 
   typedef YAML::iterator iterator;
   typedef YAML::const_iterator const_iterator;
@@ -47,6 +52,8 @@ class YAML_CPP_API Node {
   explicit Node(const T& rhs);
   explicit Node(const detail::iterator_value& rhs);
   Node(const Node& rhs);
+  Node(Node&& rhs);
+  explicit Node(std::string&& rhs);
   ~Node();
 
   YAML::Mark Mark() const;
@@ -77,10 +84,15 @@ class YAML_CPP_API Node {
   void SetStyle(EmitterStyle::value style);
 
   // assignment
+  // . A Node or std::string passed as an rvalue (to these, push_back,
+  //   force_insert or emplace) is taken over instead of copied: the string
+  //   becomes the scalar as it is, and the Node is left empty.
   bool is(const Node& rhs) const;
   template <typename T>
   Node& operator=(const T& rhs);
   Node& operator=(const Node& rhs);
+  Node& operator=(Node&& rhs);
+  Node& operator=(std::string&& rhs);
   void reset(const Node& rhs = Node());
 
   // size/iterator
@@ -96,6 +108,8 @@ class YAML_CPP_API Node {
   template <typename T>
   void push_back(const T& rhs);
   void push_back(const Node& rhs);
+  void push_back(Node&& rhs);
+  void push_back(std::string&& rhs);
 
   // indexing
   template <typename Key>
@@ -111,7 +125,31 @@ class YAML_CPP_API Node {
 
   // map
   template <typename Key, typename Value>
-  void force_insert(const Key& key, const Value& value);
+  void force_insert(Key&& key, Value&& value);
+
+  // emplace
+  // . Like force_insert, but only if there is nothing at 'key' yet (as the
+  //   const operator[] would find it); returns whether it inserted the pair.
+  template <typename Key, typename Value>
+  bool emplace(Key&& key, Value&& value);
+
+  // Freeze
+  // . Makes this node and everything under it read-only: changing any of it
+  //   throws FrozenNode, and indexing a missing key gives an invalid node
+  //   instead of adding one. Nothing is computed lazily on a frozen node, so
+  //   any number of threads may read it (and copies of it) at once, as long
+  //   as none of them assigns it into another document.
+  void Freeze();
+  bool IsFrozen() const;
+
+  // CollectGarbage
+  // . Frees the nodes of this node's memory that it can no longer reach
+  //   (those left behind by reset, remove or assignment), and returns how
+  //   many there were. Their space is reused by the nodes made after.
+  // . This node is taken to be the only root of its memory: any other Node,
+  //   NodeView or iterator into it that this node can't reach is left
+  //   dangling.
+  std::size_t CollectGarbage();
 
  private:
   enum Zombie { ZombieNode };
@@ -138,6 +176,16 @@ YAML_CPP_API bool operator==(const Node& lhs, const Node& rhs);
 
 YAML_CPP_API Node Clone(const Node& node);
 
+// CloneShared
+// . A copy of a frozen node made in constant time: the copy shares the
+//   original's nodes, and gets its own copies of them (one level at a time)
+//   only as it is changed, or iterated or indexed through a non-const Node,
+//   so a copy with a few keys changed costs about as much as those keys'
+//   paths. Reading it through a const Node copies nothing.
+// . Unlike Clone, nodes that were aliased in the original aren't once they
+//   are copied. A node that isn't frozen is cloned with Clone.
+YAML_CPP_API Node CloneShared(const Node& node);
+
 template <typename T>
 struct convert;
 }
@@ -24,6 +24,22 @@ void YAML_CPP_API ElegantErrorOutputText(Exception &exception, const std::string
 
 struct YAML_CPP_API Loader {
     bool m_textEnabled = false;
+    // share storage between identical scalars of a loaded document
+    bool m_internScalars = false;
+    // worker threads used by the parallel loads; 0 means one per core
+    unsigned m_threads = 0;
+    // deepest nesting of collections allowed (see Parser::SetMaxDepth)
+    std::size_t m_maxDepth = 0;
+    // the loaded documents are frozen (see Node::Freeze), to be shared
+    // between threads
+    bool m_freeze = false;
+    // LoadFile keeps the parsed events of each file in a cache file, and
+    // loads of the unchanged file (by the same library version) replay them
+    // instead of parsing it again
+    bool m_useCache = false;
+    // where the cache files go; empty means next to each file, as
+    // "<file>.cache"
+    std::string m_cacheDir;
     std::unique_ptr<Parser> m_parser;
 
     Loader(bool textEnabled = false);
@@ -35,10 +51,42 @@ struct YAML_CPP_API Loader {
     Node Load(std::istream& input);
     Node LoadFile(const std::string& filename);
 
+    // Like Load, for a single document whose root is a block sequence or
+    // block map: the text is split at top-level entries, the pieces parsed on
+    // m_threads threads and their entries joined under one root. Anything
+    // that can't be split that way (including aliases to anchors in another
+    // piece) goes through Load.
+    Node LoadParallel(const std::string& input);
+    Node LoadParallel(const char* input);
+    Node LoadParallel(std::istream& input);
+    Node LoadFileParallel(const std::string& filename);
+
+    // Like Load, but only keeps the parts of the document matched by one of
+    // 'paths', e.g. "services.*.port": keys separated by '.', where '*'
+    // matches any key or sequence index and a number matches that index.
+    // The rest of the text is skipped without being parsed, so errors in it
+    // aren't reported. Matched sequences keep only their matched entries, in
+    // order; a null node is returned if nothing matched.
+    Node LoadSelected(const std::string& input,
+                      const std::vector<std::string>& paths);
+    Node LoadSelected(const char* input, const std::vector<std::string>& paths);
+    Node LoadSelected(std::istream& input,
+                      const std::vector<std::string>& paths);
+    Node LoadFileSelected(const std::string& filename,
+                          const std::vector<std::string>& paths);
+
     std::vector<Node> LoadAll(const std::string& input);
     std::vector<Node> LoadAll(const char* input);
     std::vector<Node> LoadAll(std::istream& input);
     std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+    // Like LoadAll, but splits the stream at its document markers and parses
+    // the documents on m_threads threads. Streams that can't be split safely
+    // (directives, non-UTF-8 encodings) and errors go through LoadAll.
+    std::vector<Node> LoadAllParallel(const std::string& input);
+    std::vector<Node> LoadAllParallel(const char* input);
+    std::vector<Node> LoadAllParallel(std::istream& input);
+    std::vector<Node> LoadAllFromFileParallel(const std::string& filename);
 };
 }
 
@@ -0,0 +1,230 @@
+#ifndef NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/detail/bool_type.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+struct view_value;
+}
+
+// NodeView
+// . A borrowed, read-only handle to a node: a single pointer, so copying it
+//   and looking things up through it touch no reference count (as every
+//   Node does). It is only valid while the document it was taken from is,
+//   i.e. while some Node still refers to it.
+// . Looking up a key that isn't there gives an empty view, which isn't
+//   defined.
+class YAML_CPP_API NodeView {
+ public:
+  class const_iterator;
+  typedef const_iterator iterator;
+
+  NodeView() : m_pNode(NULL) {}
+  explicit NodeView(const Node& node);
+
+  YAML::Mark Mark() const;
+  NodeType::value Type() const;
+  bool IsDefined() const { return m_pNode && m_pNode->is_defined(); }
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+  bool IsFrozen() const { return m_pNode && m_pNode->is_frozen(); }
+
+  // bool conversions
+  YAML_CPP_OPERATOR_BOOL();
+  bool operator!() const { return !IsDefined(); }
+
+  // access
+  template <typename T>
+  const T as() const;
+  template <typename T, typename S>
+  const T as(const S& fallback) const;
+  const std::string& Scalar() const;
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  bool is(const NodeView& rhs) const { return m_pNode == rhs.m_pNode; }
+
+  // size/iterator
+  std::size_t size() const { return m_pNode ? m_pNode->size() : 0; }
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // indexing
+  template <typename Key>
+  NodeView operator[](const Key& key) const;
+  NodeView operator[](const NodeView& key) const;
+  NodeView operator[](const Node& key) const;
+
+ private:
+  friend struct detail::view_value;
+  explicit NodeView(const detail::node* pNode) : m_pNode(pNode) {}
+
+  // Borrow
+  // . A Node for the converters, which only read it; it holds no memory,
+  //   so it costs no reference count either.
+  Node Borrow() const {
+    return Node(const_cast<detail::node&>(*m_pNode),
+                detail::shared_memory_holder());
+  }
+
+ private:
+  const detail::node* m_pNode;
+};
+
+namespace detail {
+// view_value
+// . What a NodeView::const_iterator points to: the element of a sequence, or
+//   (as first and second) the key and value of a map's entry.
+struct view_value : public NodeView, std::pair<NodeView, NodeView> {
+  view_value() : NodeView(), std::pair<NodeView, NodeView>() {}
+  explicit view_value(const node& rhs)
+      : NodeView(&rhs), std::pair<NodeView, NodeView>() {}
+  view_value(const node& key, const node& value)
+      : NodeView(),
+        std::pair<NodeView, NodeView>(NodeView(&key), NodeView(&value)) {}
+};
+}
+
+class NodeView::const_iterator
+    : public std::iterator<std::forward_iterator_tag, detail::view_value,
+                           std::ptrdiff_t, detail::view_value*,
+                           detail::view_value> {
+ private:
+  struct proxy {
+    explicit proxy(const detail::view_value& x) : m_ref(x) {}
+    const detail::view_value* operator->() const {
+      return std::addressof(m_ref);
+    }
+
+    detail::view_value m_ref;
+  };
+
+ public:
+  const_iterator() : m_iterator() {}
+  explicit const_iterator(detail::const_node_iterator rhs) : m_iterator(rhs) {}
+
+  const_iterator& operator++() {
+    ++m_iterator;
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator iterator_pre(*this);
+    ++(*this);
+    return iterator_pre;
+  }
+
+  bool operator==(const const_iterator& rhs) const {
+    return m_iterator == rhs.m_iterator;
+  }
+  bool operator!=(const const_iterator& rhs) const {
+    return m_iterator != rhs.m_iterator;
+  }
+
+  detail::view_value operator*() const {
+    const detail::const_node_iterator::value_type& v = *m_iterator;
+    if (v.pNode)
+      return detail::view_value(*v);
+    if (v.first && v.second)
+      return detail::view_value(*v.first, *v.second);
+    return detail::view_value();
+  }
+  proxy operator->() const { return proxy(**this); }
+
+ private:
+  detail::const_node_iterator m_iterator;
+};
+
+inline NodeView::NodeView(const Node& node) : m_pNode(NULL) {
+  if (node.m_isValid) {
+    node.EnsureNodeExists();
+    m_pNode = node.m_pNode;
+  }
+}
+
+inline Mark NodeView::Mark() const {
+  return m_pNode ? m_pNode->mark() : Mark::null_mark();
+}
+
+inline NodeType::value NodeView::Type() const {
+  return m_pNode ? m_pNode->type() : NodeType::Undefined;
+}
+
+template <typename T>
+inline const T NodeView::as() const {
+  if (!m_pNode)
+    throw InvalidNode();
+  return as_if<T, void>(Borrow())();
+}
+
+template <typename T, typename S>
+inline const T NodeView::as(const S& fallback) const {
+  if (!m_pNode)
+    return fallback;
+  return as_if<T, S>(Borrow())(fallback);
+}
+
+inline const std::string& NodeView::Scalar() const {
+  return m_pNode ? m_pNode->scalar() : detail::node_data::empty_scalar;
+}
+
+inline const std::string& NodeView::Tag() const {
+  return m_pNode ? m_pNode->tag() : detail::node_data::empty_scalar;
+}
+
+inline EmitterStyle::value NodeView::Style() const {
+  return m_pNode ? m_pNode->style() : EmitterStyle::Default;
+}
+
+inline NodeView::const_iterator NodeView::begin() const {
+  return m_pNode ? const_iterator(m_pNode->begin()) : const_iterator();
+}
+
+inline NodeView::const_iterator NodeView::end() const {
+  return m_pNode ? const_iterator(m_pNode->end()) : const_iterator();
+}
+
+template <typename Key>
+inline NodeView NodeView::operator[](const Key& key) const {
+  if (!m_pNode)
+    return NodeView();
+  return NodeView(
+      m_pNode->get(detail::to_value(key), detail::shared_memory_holder()));
+}
+
+inline NodeView NodeView::operator[](const NodeView& key) const {
+  if (!m_pNode || !key.m_pNode)
+    return NodeView();
+  return NodeView(m_pNode->get(const_cast<detail::node&>(*key.m_pNode),
+                               detail::shared_memory_holder()));
+}
+
+inline NodeView NodeView::operator[](const Node& key) const {
+  return (*this)[NodeView(key)];
+}
+}
+
+#endif  // NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
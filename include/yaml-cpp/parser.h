@@ -7,20 +7,27 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <memory>
 
 #include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/noncopyable.h"
 
 namespace YAML {
-class EventHandler;
 class Node;
+class NodeBuilder;
 class Scanner;
+class SingleDocParser;
+class ViewEventHandler;
 struct Directives;
+struct Event;
 struct Token;
 
 class YAML_CPP_API Parser : private noncopyable {
+  friend class NodeBuilder;
+
  public:
   Parser();
   Parser(std::istream& in, bool textEnabled = false);
@@ -28,13 +35,43 @@ class YAML_CPP_API Parser : private noncopyable {
 
   operator bool() const;
 
-  void Load(std::istream& in, bool textEnabled = false);
-  bool HandleNextDocument(EventHandler& eventHandler);
+  // start is the position of the first character of 'in' within a larger
+  // stream, so marks of a fragment parsed on its own still refer to the whole
+  void Load(std::istream& in, bool textEnabled = false,
+            const Mark& start = Mark());
+  bool HandleNextDocument(ViewEventHandler& eventHandler);
+
+  // SetMaxDepth
+  // . Collections nested more than 'maxDepth' deep are a ParserException;
+  //   0 (the default) means no limit.
+  void SetMaxDepth(std::size_t maxDepth);
+
+  // NextEvent
+  // . Pulls the next event of the stream into 'event', parsing only as far
+  //   as that takes; returns false at the end of the stream.
+  // . A document that was started this way is finished first by a later
+  //   HandleNextDocument, which hands it the remaining events.
+  bool NextEvent(Event& event);
+
+  // InDocument
+  // . True if a document was left unfinished, by NextEvent or by a handler
+  //   that stopped parsing.
+  bool InDocument() const;
+
+  // SkipDocument
+  // . Drops the rest of an unfinished document, up to the next one, without
+  //   parsing it (it is still scanned, so scanner errors are reported).
+  void SkipDocument();
 
   void PrintTokens(std::ostream& out);
   std::string GetText() const;
 
  private:
+  // the same for the library's own node builder, which the parser calls
+  // without virtual dispatch (see NodeBuilder::HandleNextDocument)
+  bool HandleNextDocument(NodeBuilder& builder);
+
+  SingleDocParser* CurrentDocument();
   void ParseDirectives();
   void HandleDirective(const Token& token);
   void HandleYamlDirective(const Token& token);
@@ -43,6 +80,11 @@ class YAML_CPP_API Parser : private noncopyable {
  private:
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
+  // the document in progress: left unfinished by NextEvent or by a handler
+  // that stopped parsing, and resumed or dropped by the next call to
+  // NextEvent, HandleNextDocument or SkipDocument; see InDocument
+  std::unique_ptr<SingleDocParser> m_pDocument;
+  std::size_t m_maxDepth;
 };
 }
 
@@ -0,0 +1,70 @@
+#ifndef STRINGVIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define STRINGVIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace YAML {
+// A non-owning view of characters that live somewhere else (e.g. in the
+// scanner); only valid as long as they do. When it views a whole
+// std::string, it remembers it, so that str(buffer) can hand it out without
+// a copy.
+class StringView {
+ public:
+  StringView() : m_data(""), m_size(0), m_pString(NULL) {}
+  StringView(const std::string& str)
+      : m_data(str.data()), m_size(str.size()), m_pString(&str) {}
+  StringView(const char* str)
+      : m_data(str), m_size(std::strlen(str)), m_pString(NULL) {}
+  StringView(const char* data, std::size_t size)
+      : m_data(data), m_size(size), m_pString(NULL) {}
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const char* begin() const { return m_data; }
+  const char* end() const { return m_data + m_size; }
+  char operator[](std::size_t i) const { return m_data[i]; }
+
+  std::string str() const {
+    return m_pString ? *m_pString : std::string(m_data, m_size);
+  }
+
+  // the viewed std::string itself, if any, or else a copy in 'buffer'
+  const std::string& str(std::string& buffer) const {
+    if (m_pString)
+      return *m_pString;
+    buffer.assign(m_data, m_size);
+    return buffer;
+  }
+
+ private:
+  const char* m_data;
+  std::size_t m_size;
+  const std::string* m_pString;
+};
+
+inline bool operator==(const StringView& lhs, const StringView& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+inline bool operator!=(const StringView& lhs, const StringView& rhs) {
+  return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out, const StringView& view) {
+  return out.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+}
+
+#endif  // STRINGVIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
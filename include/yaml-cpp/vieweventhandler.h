@@ -0,0 +1,65 @@
+#ifndef VIEWEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VIEWEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/stringview.h"
+
+namespace YAML {
+class EventTape;
+class SingleDocParser;
+struct Mark;
+
+// The events of a document, with tags and scalars passed as views into the
+// parser's own memory; they're only valid during the call. Handlers that
+// just inspect or forward them don't need a std::string per event.
+// EventHandler is the same interface with std::strings.
+class ViewEventHandler {
+ public:
+  ViewEventHandler() : m_stopRequested(false) {}
+  virtual ~ViewEventHandler() {}
+
+  // StopParsing
+  // . Called from a callback, makes Parser::HandleNextDocument return right
+  //   after it, without an exception; the rest of the document is left for
+  //   the next call (or Parser::SkipDocument). EventTape::Replay stops too.
+  void StopParsing() { m_stopRequested = true; }
+
+  virtual void OnDocumentStart(const Mark& mark) = 0;
+  virtual void OnDocumentEnd() = 0;
+
+  virtual void OnNull(const Mark& mark, anchor_t anchor) = 0;
+  virtual void OnAlias(const Mark& mark, anchor_t anchor) = 0;
+  virtual void OnScalarView(const Mark& mark, const StringView& tag,
+                            anchor_t anchor, const StringView& value) = 0;
+
+  virtual void OnSequenceStartView(const Mark& mark, const StringView& tag,
+                                   anchor_t anchor,
+                                   EmitterStyle::value style) = 0;
+  virtual void OnSequenceEnd() = 0;
+
+  virtual void OnMapStartView(const Mark& mark, const StringView& tag,
+                              anchor_t anchor, EmitterStyle::value style) = 0;
+  virtual void OnMapEnd() = 0;
+
+ private:
+  friend class EventTape;
+  friend class SingleDocParser;
+
+  bool TakeStopRequest() {
+    const bool stopRequested = m_stopRequested;
+    m_stopRequested = false;
+    return stopRequested;
+  }
+
+  bool m_stopRequested;
+};
+}
+
+#endif  // VIEWEVENTHANDLER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -8,6 +8,8 @@
 #endif
 
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/event.h"
+#include "yaml-cpp/eventtape.h"
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/stlemitter.h"
@@ -19,6 +21,8 @@
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/detail/impl.h"
 #include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/node/view.h"
 #include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/compare.h"
 
 #endif  // YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,211 @@
+#include <unordered_map>
+#include <utility>
+
+#include "yaml-cpp/node/compare.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_data.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/iterator.h"
+
+namespace YAML {
+namespace {
+bool SameTag(const std::string& lhs, const std::string& rhs) {
+  return lhs == rhs || (detail::node_data::is_nonspecific(lhs) &&
+                        detail::node_data::is_nonspecific(rhs));
+}
+
+bool Equal(const detail::node& lhs, const detail::node& rhs);
+
+bool EqualSequences(const detail::node& lhs, const detail::node& rhs) {
+  detail::const_node_iterator l = lhs.begin(), r = rhs.begin();
+  for (; l != lhs.end() && r != rhs.end(); ++l, ++r) {
+    if (!Equal(**l, **r))
+      return false;
+  }
+  return l == lhs.end() && r == rhs.end();
+}
+
+bool EqualMaps(const detail::node& lhs, const detail::node& rhs) {
+  // rhs's entries by their key's hash, each to be matched once
+  typedef std::pair<const detail::node*, const detail::node*> Entry;
+  typedef std::unordered_multimap<std::size_t, Entry> Entries;
+  Entries entries;
+  for (detail::const_node_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+    const detail::const_node_iterator::value_type& entry = *it;
+    entries.insert(Entries::value_type(entry.first->hash(),
+                                       Entry(entry.first, entry.second)));
+  }
+
+  for (detail::const_node_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+    const detail::const_node_iterator::value_type& entry = *it;
+    std::pair<Entries::iterator, Entries::iterator> range =
+        entries.equal_range(entry.first->hash());
+    Entries::iterator match = range.first;
+    while (match != range.second && !Equal(*entry.first, *match->second.first))
+      ++match;
+    if (match == range.second || !Equal(*entry.second, *match->second.second))
+      return false;
+    entries.erase(match);
+  }
+  return entries.empty();
+}
+
+bool Equal(const detail::node& lhs, const detail::node& rhs) {
+  if (lhs.is(rhs))
+    return true;
+  if (lhs.hash() != rhs.hash() || lhs.type() != rhs.type() ||
+      !SameTag(lhs.tag(), rhs.tag()))
+    return false;
+
+  switch (lhs.type()) {
+    case NodeType::Scalar:
+      return lhs.scalar() == rhs.scalar();
+    case NodeType::Sequence:
+      return EqualSequences(lhs, rhs);
+    case NodeType::Map:
+      return EqualMaps(lhs, rhs);
+    default:
+      return true;
+  }
+}
+
+void AddChange(ChangeType::value type, const std::vector<Node>& path,
+               const Node& from, const Node& to,
+               std::vector<NodeChange>& changes) {
+  NodeChange change;
+  change.type = type;
+  change.path = path;
+  change.from = from;
+  change.to = to;
+  changes.push_back(change);
+}
+
+void Added(const std::vector<Node>& path, const Node& to,
+           std::vector<NodeChange>& changes) {
+  AddChange(ChangeType::Added, path, Node(NodeType::Undefined), to, changes);
+}
+
+void Removed(const std::vector<Node>& path, const Node& from,
+             std::vector<NodeChange>& changes) {
+  AddChange(ChangeType::Removed, path, from, Node(NodeType::Undefined),
+            changes);
+}
+
+void DiffNodes(const Node& from, const Node& to, std::vector<Node>& path,
+               std::vector<NodeChange>& changes);
+
+void DiffSequences(const Node& from, const Node& to, std::vector<Node>& path,
+                   std::vector<NodeChange>& changes) {
+  const_iterator f = from.begin(), t = to.begin();
+  std::size_t i = 0;
+  for (; f != from.end() && t != to.end(); ++f, ++t, ++i) {
+    path.push_back(Node(i));
+    DiffNodes(*f, *t, path, changes);
+    path.pop_back();
+  }
+  for (; f != from.end(); ++f, ++i) {
+    path.push_back(Node(i));
+    Removed(path, *f, changes);
+    path.pop_back();
+  }
+  for (; t != to.end(); ++t, ++i) {
+    path.push_back(Node(i));
+    Added(path, *t, changes);
+    path.pop_back();
+  }
+}
+
+void DiffMaps(const Node& from, const Node& to, std::vector<Node>& path,
+              std::vector<NodeChange>& changes) {
+  // to's entries, by their key's hash, each to be matched once
+  std::vector<std::pair<Node, Node> > entries;
+  std::vector<bool> matched;
+  typedef std::unordered_multimap<std::size_t, std::size_t> Keys;
+  Keys keys;
+  for (const_iterator it = to.begin(); it != to.end(); ++it) {
+    keys.insert(Keys::value_type(Hash(it->first), entries.size()));
+    entries.push_back(std::make_pair(it->first, it->second));
+    matched.push_back(false);
+  }
+
+  for (const_iterator it = from.begin(); it != from.end(); ++it) {
+    std::pair<Keys::iterator, Keys::iterator> range =
+        keys.equal_range(Hash(it->first));
+    Keys::iterator match = range.first;
+    while (match != range.second &&
+           (matched[match->second] ||
+            !Equals(it->first, entries[match->second].first)))
+      ++match;
+
+    path.push_back(it->first);
+    if (match != range.second) {
+      matched[match->second] = true;
+      DiffNodes(it->second, entries[match->second].second, path, changes);
+    } else {
+      Removed(path, it->second, changes);
+    }
+    path.pop_back();
+  }
+
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    if (matched[i])
+      continue;
+    path.push_back(entries[i].first);
+    Added(path, entries[i].second, changes);
+    path.pop_back();
+  }
+}
+
+void DiffNodes(const Node& from, const Node& to, std::vector<Node>& path,
+               std::vector<NodeChange>& changes) {
+  if (!from.IsDefined() || !to.IsDefined()) {
+    if (from.IsDefined())
+      Removed(path, from, changes);
+    else if (to.IsDefined())
+      Added(path, to, changes);
+    return;
+  }
+
+  if (Hash(from) == Hash(to))
+    return;
+
+  const NodeType::value type = from.Type();
+  if (type != to.Type() || !SameTag(from.Tag(), to.Tag())) {
+    AddChange(ChangeType::Changed, path, from, to, changes);
+  } else if (type == NodeType::Sequence) {
+    DiffSequences(from, to, path, changes);
+  } else if (type == NodeType::Map) {
+    DiffMaps(from, to, path, changes);
+  } else {
+    AddChange(ChangeType::Changed, path, from, to, changes);
+  }
+}
+}
+
+bool Equals(const Node& lhs, const Node& rhs) {
+  // an invalid node is taken to be undefined
+  if (!lhs.m_isValid || !rhs.m_isValid)
+    return !lhs.IsDefined() && !rhs.IsDefined();
+
+  lhs.EnsureNodeExists();
+  rhs.EnsureNodeExists();
+  return Equal(*lhs.m_pNode, *rhs.m_pNode);
+}
+
+std::size_t Hash(const Node& node) {
+  if (!node.m_isValid)
+    return static_cast<std::size_t>(NodeType::Undefined);
+
+  node.EnsureNodeExists();
+  return node.m_pNode->hash();
+}
+
+std::vector<NodeChange> Diff(const Node& from, const Node& to) {
+  std::vector<NodeChange> changes;
+  std::vector<Node> path;
+  DiffNodes(from, to, path, changes);
+  return changes;
+}
+}
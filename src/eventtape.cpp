@@ -0,0 +1,308 @@
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include "yaml-cpp/eventtape.h"
+#include "yaml-cpp/event.h"
+#include "yaml-cpp/exceptions.h"
+
+namespace YAML {
+namespace {
+const char TapeMagic[8] = {'Y', 'A', 'M', 'L', 'T', 'A', 'P', 'E'};
+
+// what Save writes first; the sections that follow are 8-byte aligned
+struct TapeHeader {
+  char magic[8];
+  std::uint32_t entrySize;
+  std::uint32_t tagCount;  // including the empty tag, which isn't written
+  std::uint64_t events;
+  std::uint64_t scalars;  // bytes, before padding
+  std::uint64_t tags;     // bytes: a length and the characters of each tag
+};
+
+std::size_t Padding(std::size_t size) { return (8 - size % 8) % 8; }
+}
+
+EventTape::EventTape() { clear(); }
+
+EventTape::~EventTape() {}
+
+void EventTape::clear() {
+  m_events.clear();
+  m_scalars.clear();
+  m_tags.clear();
+  m_tagIds.clear();
+
+  // id 0 is the empty tag, of the events that have none
+  m_tags.push_back(std::string());
+  m_tagIds[std::string()] = 0;
+}
+
+bool EventTape::Replay(ViewEventHandler& eventHandler,
+                       std::size_t maxDepth) const {
+  std::size_t value = 0;  // where the next scalar starts
+  std::size_t depth = 0;
+  for (std::size_t i = 0; i < m_events.size(); i++) {
+    const Entry& entry = m_events[i];
+    if (entry.type == EventType::SequenceStart ||
+        entry.type == EventType::MapStart) {
+      if (maxDepth && ++depth > maxDepth)
+        throw ParserException(entry.mark, ErrorMsg::NESTING_TOO_DEEP);
+    } else if (entry.type == EventType::SequenceEnd ||
+               entry.type == EventType::MapEnd) {
+      depth--;
+    }
+
+    const EmitterStyle::value style =
+        static_cast<EmitterStyle::value>(entry.style);
+    switch (entry.type) {
+      case EventType::DocumentStart:
+        eventHandler.OnDocumentStart(entry.mark);
+        break;
+      case EventType::DocumentEnd:
+        eventHandler.OnDocumentEnd();
+        break;
+      case EventType::Null:
+        eventHandler.OnNull(entry.mark, entry.anchor);
+        break;
+      case EventType::Alias:
+        eventHandler.OnAlias(entry.mark, entry.anchor);
+        break;
+      case EventType::Scalar:
+        eventHandler.OnScalarView(
+            entry.mark, m_tags[entry.tag], entry.anchor,
+            StringView(m_scalars.data() + value, entry.size));
+        value += entry.size;
+        break;
+      case EventType::SequenceStart:
+        eventHandler.OnSequenceStartView(entry.mark, m_tags[entry.tag],
+                                         entry.anchor, style);
+        break;
+      case EventType::SequenceEnd:
+        eventHandler.OnSequenceEnd();
+        break;
+      case EventType::MapStart:
+        eventHandler.OnMapStartView(entry.mark, m_tags[entry.tag],
+                                    entry.anchor, style);
+        break;
+      case EventType::MapEnd:
+        eventHandler.OnMapEnd();
+        break;
+    }
+    if (eventHandler.TakeStopRequest())
+      return i + 1 == m_events.size();
+  }
+  return true;
+}
+
+void EventTape::Save(std::ostream& out) const {
+  static_assert(sizeof(Entry) == 28, "EventTape::Entry has padding");
+
+  TapeHeader header;
+  std::memcpy(header.magic, TapeMagic, sizeof(TapeMagic));
+  header.entrySize = sizeof(Entry);
+  header.tagCount = static_cast<std::uint32_t>(m_tags.size());
+  header.events = m_events.size();
+  header.scalars = m_scalars.size();
+  header.tags = 0;
+  for (std::size_t i = 1; i < m_tags.size(); i++)
+    header.tags += sizeof(std::uint32_t) + m_tags[i].size();
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!m_events.empty())
+    out.write(reinterpret_cast<const char*>(&m_events[0]),
+              static_cast<std::streamsize>(m_events.size() * sizeof(Entry)));
+  out.write(m_scalars.data(), static_cast<std::streamsize>(m_scalars.size()));
+  const char zeros[8] = {};
+  out.write(zeros, static_cast<std::streamsize>(Padding(m_scalars.size())));
+  for (std::size_t i = 1; i < m_tags.size(); i++) {
+    const std::uint32_t size = static_cast<std::uint32_t>(m_tags[i].size());
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(m_tags[i].data(), size);
+  }
+}
+
+bool EventTape::Restore(const char* data, std::size_t size) {
+  clear();
+
+  TapeHeader header;
+  if (size < sizeof(header))
+    return false;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, TapeMagic, sizeof(TapeMagic)) != 0 ||
+      header.entrySize != sizeof(Entry) || header.tagCount == 0)
+    return false;
+
+  // the sections have to fill the rest exactly
+  std::size_t rest = size - sizeof(header);
+  if (header.events > rest / sizeof(Entry))
+    return false;
+  const std::size_t eventBytes =
+      static_cast<std::size_t>(header.events) * sizeof(Entry);
+  rest -= eventBytes;
+  if (header.scalars > rest || Padding(header.scalars) > rest - header.scalars)
+    return false;
+  const std::size_t scalarBytes = static_cast<std::size_t>(header.scalars);
+  rest -= scalarBytes + Padding(scalarBytes);
+  if (header.tags != rest)
+    return false;
+
+  const char* p = data + sizeof(header);
+  m_events.resize(static_cast<std::size_t>(header.events));
+  if (eventBytes > 0)
+    std::memcpy(&m_events[0], p, eventBytes);
+  p += eventBytes;
+  m_scalars.assign(p, scalarBytes);
+  p += scalarBytes + Padding(scalarBytes);
+
+  const char* end = data + size;
+  for (std::uint32_t i = 1; i < header.tagCount; i++) {
+    std::uint32_t tagSize;
+    if (static_cast<std::size_t>(end - p) < sizeof(tagSize))
+      break;
+    std::memcpy(&tagSize, p, sizeof(tagSize));
+    p += sizeof(tagSize);
+    if (static_cast<std::size_t>(end - p) < tagSize)
+      break;
+    m_tagIds[std::string(p, tagSize)] = i;
+    m_tags.push_back(std::string(p, tagSize));
+    p += tagSize;
+  }
+
+  if (p != end || m_tags.size() != header.tagCount || !Check()) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+// Check
+// . Makes sure that replaying the events can't go wrong: the indices are
+//   in range, and the documents and collections are whole and nested right.
+bool EventTape::Check() const {
+  std::size_t scalars = 0;
+  std::vector<unsigned char> open;
+  bool inDocument = false;
+  anchor_t lastAnchor = NullAnchor;
+  for (std::size_t i = 0; i < m_events.size(); i++) {
+    const Entry& entry = m_events[i];
+    if (entry.tag >= m_tags.size() || entry.style > EmitterStyle::Flow ||
+        entry.unused != 0 || entry.size > m_scalars.size() - scalars ||
+        (entry.size > 0 && entry.type != EventType::Scalar))
+      return false;
+    scalars += entry.size;
+
+    switch (entry.type) {
+      case EventType::DocumentStart:
+        if (inDocument)
+          return false;
+        inDocument = true;
+        lastAnchor = NullAnchor;
+        break;
+      case EventType::DocumentEnd:
+        if (!inDocument || !open.empty())
+          return false;
+        inDocument = false;
+        break;
+      case EventType::Alias:
+        if (!inDocument || entry.anchor == NullAnchor ||
+            entry.anchor > lastAnchor)
+          return false;
+        break;
+      case EventType::Null:
+      case EventType::Scalar:
+      case EventType::SequenceStart:
+      case EventType::MapStart:
+        // anchors are numbered in order, from 1 in each document
+        if (!inDocument ||
+            (entry.anchor != NullAnchor && entry.anchor != lastAnchor + 1))
+          return false;
+        if (entry.anchor != NullAnchor)
+          lastAnchor = entry.anchor;
+        if (entry.type == EventType::SequenceStart ||
+            entry.type == EventType::MapStart)
+          open.push_back(entry.type);
+        break;
+      case EventType::SequenceEnd:
+      case EventType::MapEnd:
+        // each end comes right after its start in EventType
+        if (open.empty() || open.back() + 1 != entry.type)
+          return false;
+        open.pop_back();
+        break;
+      default:
+        return false;
+    }
+  }
+  return !inDocument && scalars == m_scalars.size();
+}
+
+void EventTape::OnDocumentStart(const Mark& mark) {
+  Add(EventType::DocumentStart, mark);
+}
+
+void EventTape::OnDocumentEnd() { Add(EventType::DocumentEnd, Mark()); }
+
+void EventTape::OnNull(const Mark& mark, anchor_t anchor) {
+  Add(EventType::Null, mark, anchor);
+}
+
+void EventTape::OnAlias(const Mark& mark, anchor_t anchor) {
+  Add(EventType::Alias, mark, anchor);
+}
+
+void EventTape::OnScalarView(const Mark& mark, const StringView& tag,
+                             anchor_t anchor, const StringView& value) {
+  if (value.size() > std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("EventTape: scalar over 4 GiB");
+  Add(EventType::Scalar, mark, anchor, TagId(tag));
+  m_events.back().size = static_cast<std::uint32_t>(value.size());
+  m_scalars.append(value.data(), value.size());
+}
+
+void EventTape::OnSequenceStartView(const Mark& mark, const StringView& tag,
+                                    anchor_t anchor,
+                                    EmitterStyle::value style) {
+  Add(EventType::SequenceStart, mark, anchor, TagId(tag), style);
+}
+
+void EventTape::OnSequenceEnd() { Add(EventType::SequenceEnd, Mark()); }
+
+void EventTape::OnMapStartView(const Mark& mark, const StringView& tag,
+                               anchor_t anchor, EmitterStyle::value style) {
+  Add(EventType::MapStart, mark, anchor, TagId(tag), style);
+}
+
+void EventTape::OnMapEnd() { Add(EventType::MapEnd, Mark()); }
+
+void EventTape::Add(unsigned char type, const Mark& mark, anchor_t anchor,
+                    std::uint32_t tag, EmitterStyle::value style) {
+  Entry entry = Entry();
+  entry.mark = mark;
+  entry.type = type;
+  entry.style = static_cast<unsigned char>(style);
+  entry.tag = tag;
+  entry.anchor = static_cast<std::uint32_t>(anchor);
+  m_events.push_back(entry);
+}
+
+// TagId
+// . Most nodes share a few tags, so each is stored once; runs of the same
+//   tag only compare it with the last one.
+std::uint32_t EventTape::TagId(const StringView& tag) {
+  if (!m_events.empty() && m_events.back().tag != 0 &&
+      StringView(m_tags[m_events.back().tag]) == tag)
+    return m_events.back().tag;
+
+  m_tagKey.assign(tag.data(), tag.size());
+  TagIds::const_iterator it = m_tagIds.find(m_tagKey);
+  if (it != m_tagIds.end())
+    return it->second;
+
+  const std::uint32_t id = static_cast<std::uint32_t>(m_tags.size());
+  m_tags.push_back(m_tagKey);
+  m_tagIds[m_tagKey] = id;
+  return id;
+}
+}
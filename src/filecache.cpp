@@ -0,0 +1,179 @@
+#include "filecache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "yaml-cpp/eventtape.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "textchunk.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// set by the build, from the project's version
+#ifndef YAML_CPP_VERSION_STRING
+#define YAML_CPP_VERSION_STRING "unknown"
+#endif
+
+namespace YAML {
+namespace {
+const char CacheMagic[8] = {'Y', 'A', 'M', 'L', 'C', 'A', 'C', 'H'};
+
+struct CacheHeader {
+  char magic[8];
+  char version[24];  // the library's, zero-padded
+  std::uint64_t textSize;
+  std::uint64_t textHash;
+};
+
+// Hash
+// . 64-bit FNV-1a; it runs much faster than the text could be parsed.
+std::uint64_t Hash(const char* data, std::size_t size) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+void FillHeader(CacheHeader& header, const std::string& text) {
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+  std::strncpy(header.version, YAML_CPP_VERSION_STRING,
+               sizeof(header.version) - 1);
+  header.textSize = text.size();
+  header.textHash = 0;  // hashing the text is left to the caller
+}
+
+// the bytes of a file, mapped into memory where that's possible
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) : m_data(NULL), m_size(0) {
+#ifdef _WIN32
+    std::ifstream fin(path.c_str(), std::ios::binary);
+    if (!fin)
+      return;
+    m_buffer = ReadAll(fin);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(NULL, static_cast<std::size_t>(st.st_size), PROT_READ,
+                        MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        m_data = static_cast<const char*>(data);
+        m_size = static_cast<std::size_t>(st.st_size);
+      }
+    }
+    close(fd);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (m_data)
+      munmap(const_cast<char*>(m_data), m_size);
+#endif
+  }
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+
+ private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  const char* m_data;
+  std::size_t m_size;
+#ifdef _WIN32
+  std::string m_buffer;
+#endif
+};
+}
+
+std::string CachePath(const std::string& filename,
+                      const std::string& cacheDir) {
+  if (cacheDir.empty())
+    return filename + ".cache";
+
+  std::stringstream path;
+  path << cacheDir;
+  if (cacheDir[cacheDir.size() - 1] != '/')
+    path << '/';
+  path << std::hex << Hash(filename.data(), filename.size()) << ".yaml.cache";
+  return path.str();
+}
+
+bool ReadCache(const std::string& path, const std::string& text,
+               EventTape& tape) {
+  MappedFile file(path);
+  if (file.size() < sizeof(CacheHeader))
+    return false;
+
+  // the cheap checks go first: the version and the size of the text
+  CacheHeader expected, header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  FillHeader(expected, text);
+  expected.textHash = header.textHash;
+  if (std::memcmp(&header, &expected, sizeof(header)) != 0 ||
+      header.textHash != Hash(text.data(), text.size()))
+    return false;
+
+  return tape.Restore(file.data() + sizeof(header),
+                      file.size() - sizeof(header));
+}
+
+void WriteCache(const std::string& path, const std::string& text,
+                const EventTape& tape) {
+  // written aside and renamed into place, so that readers never see half a
+  // file; each writer (in this process or another) has a file of its own,
+  // and the last one renamed wins
+  static std::atomic<unsigned> writers(0);
+  std::stringstream tempPath;
+#ifdef _WIN32
+  tempPath << path << ".tmp" << GetCurrentProcessId();
+#else
+  tempPath << path << ".tmp" << getpid();
+#endif
+  tempPath << '.' << writers++;
+  {
+    std::ofstream out(tempPath.str().c_str(), std::ios::binary);
+    if (!out)
+      return;
+    CacheHeader header;
+    FillHeader(header, text);
+    header.textHash = Hash(text.data(), text.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    tape.Save(out);
+    if (!out) {
+      out.close();
+      std::remove(tempPath.str().c_str());
+      return;
+    }
+  }
+
+#ifdef _WIN32
+  // rename doesn't replace an existing file there
+  if (!MoveFileExA(tempPath.str().c_str(), path.c_str(),
+                   MOVEFILE_REPLACE_EXISTING))
+    std::remove(tempPath.str().c_str());
+#else
+  if (std::rename(tempPath.str().c_str(), path.c_str()) != 0)
+    std::remove(tempPath.str().c_str());
+#endif
+}
+}
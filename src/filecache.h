@@ -0,0 +1,37 @@
+#ifndef FILECACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define FILECACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <string>
+
+namespace YAML {
+class EventTape;
+
+// Cache files of the events parsed from a YAML file, so that loading it
+// again only replays them. A cache file is an EventTape (see Save) behind a
+// header with the library version and the size and hash of the text it
+// was parsed from; any change to either makes it stale.
+
+// CachePath
+// . Where the cache of 'filename' goes: next to it, or in 'cacheDir' (named
+//   by a hash of 'filename') if that isn't empty.
+std::string CachePath(const std::string& filename, const std::string& cacheDir);
+
+// ReadCache
+// . Fills 'tape' from the cache file at 'path' if it exists and is one for
+//   'text'; returns false otherwise.
+bool ReadCache(const std::string& path, const std::string& text,
+               EventTape& tape);
+
+// WriteCache
+// . Writes the cache file for 'text'; a failure only means there's no cache.
+void WriteCache(const std::string& path, const std::string& text,
+                const EventTape& tape);
+}
+
+#endif  // FILECACHE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
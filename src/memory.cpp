@@ -1,26 +1,311 @@
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
+#include "yaml-cpp/node/detail/node_data.h"
 #include "yaml-cpp/node/ptr.h"
 
 namespace YAML {
 namespace detail {
+// node_arena
+// . Makes each node in one piece with its ref and data, out of chunks that
+//   grow as the document does (starting from one node, since many memories
+//   only ever hold one), and destroys them all at once. A node whose ref or
+//   data is replaced keeps the old one until then, as it does nodes that are
+//   no longer reachable, unless memory::collect frees them: their blocks are
+//   then reused, and chunks left empty are given back.
+class node_arena {
+ public:
+  node_arena() {}
+  ~node_arena() {
+    for (std::size_t i = 0; i < m_chunks.size(); i++)
+      release(m_chunks[i]);
+  }
+  node_arena(const node_arena&) = delete;
+  node_arena& operator=(const node_arena&) = delete;
+
+  node& create() {
+    block* pBlock;
+    if (!m_free.empty()) {
+      const slot free = m_free.back();
+      m_free.pop_back();
+      m_chunks[free.first].isFree[free.second] = false;
+      pBlock = new (m_chunks[free.first].begin + free.second) block;
+    } else {
+      if (m_chunks.empty() || m_chunks.back().size == m_chunks.back().capacity)
+        grow();
+      chunk& c = m_chunks.back();
+      pBlock = new (c.begin + c.size) block;
+      c.isFree.push_back(false);
+      ++c.size;
+    }
+    return pBlock->n;
+  }
+
+  bool empty() const { return m_chunks.empty(); }
+
+  // collect
+  // . See memory::collect.
+  static std::size_t collect(const std::vector<node_arena*>& arenas,
+                             node& root);
+
+ private:
+  struct block {
+    block() : ref(data), n(ref) {}
+
+    node_data data;
+    node_ref ref;
+    node n;
+  };
+
+  struct chunk {
+    block* begin;
+    std::size_t capacity;
+    std::size_t size;          // blocks made so far
+    std::vector<bool> isFree;  // of those, the ones freed since
+  };
+
+  // a chunk and a block in it
+  typedef std::pair<std::size_t, std::size_t> slot;
+
+  void grow() {
+    const std::size_t capacity =
+        m_chunks.empty() ? 1 : std::min<std::size_t>(
+                                   2 * m_chunks.back().capacity, 4096);
+    chunk c;
+    c.begin = static_cast<block*>(::operator new(capacity * sizeof(block)));
+    c.capacity = capacity;
+    c.size = 0;
+    c.isFree.reserve(capacity);
+    m_chunks.push_back(c);
+  }
+
+  void compact();
+
+  static void release(chunk& c) {
+    for (std::size_t i = 0; i < c.size; i++) {
+      if (!c.isFree[i])
+        c.begin[i].~block();
+    }
+    ::operator delete(c.begin);
+  }
+
+  std::vector<chunk> m_chunks;
+  std::vector<slot> m_free;
+};
+
+// node_arena::collect
+// . Frees every block of 'arenas' that 'root' can't reach (through a node's
+//   ref, the ref's data, and the data's elements), and returns how many it
+//   freed. A block stays whole while any of its node, ref or data is
+//   reachable.
+// . The nodes kept drop their dependencies on the ones freed, since they
+//   would otherwise tell them they've been defined, and their links to them
+//   (see node_data::add_owner).
+std::size_t node_arena::collect(const std::vector<node_arena*>& arenas,
+                                node& root) {
+  enum { NodeSeen = 1, RefSeen = 2, DataSeen = 4 };
+
+  // the chunks by address, to find the block a pointer is in
+  struct span {
+    const char* begin;
+    const char* end;
+    chunk* pChunk;
+    std::vector<unsigned char> seen;  // per block
+
+    bool operator<(const span& rhs) const { return begin < rhs.begin; }
+  };
+  std::vector<span> spans;
+  for (std::size_t i = 0; i < arenas.size(); i++) {
+    std::vector<chunk>& chunks = arenas[i]->m_chunks;
+    for (std::size_t j = 0; j < chunks.size(); j++) {
+      span s;
+      s.begin = reinterpret_cast<const char*>(chunks[j].begin);
+      s.end = reinterpret_cast<const char*>(chunks[j].begin + chunks[j].size);
+      s.pChunk = &chunks[j];
+      s.seen.resize(chunks[j].size, 0);
+      spans.push_back(s);
+    }
+  }
+  std::sort(spans.begin(), spans.end());
+
+  // what's been seen of the block 'p' points into; NULL if it isn't ours
+  auto seen = [&spans](const void* p) -> unsigned char* {
+    span key;
+    key.begin = static_cast<const char*>(p);
+    std::vector<span>::iterator it =
+        std::upper_bound(spans.begin(), spans.end(), key);
+    if (it == spans.begin() || key.begin >= (--it)->end)
+      return NULL;
+    return &it->seen[(key.begin - it->begin) / sizeof(block)];
+  };
+  // sees one part of a block; false if it had been already
+  auto see = [&seen](const void* p, unsigned char part) {
+    unsigned char* pSeen = seen(p);
+    if (!pSeen || (*pSeen & part))
+      return false;
+    *pSeen |= part;
+    return true;
+  };
+
+  std::vector<node*> pending(1, &root);
+  while (!pending.empty()) {
+    node* pNode = pending.back();
+    pending.pop_back();
+    if (!see(pNode, NodeSeen))
+      continue;
+    const node_ref* pRef = pNode->ref();
+    if (!see(pRef, RefSeen))
+      continue;
+    const node_data* pData = pRef->data();
+    if (see(pData, DataSeen))
+      pData->push_children(pending);
+  }
+
+  // whether 'p' points into a block that is about to be freed
+  auto freed_soon = [&seen](const void* p) {
+    const unsigned char* pSeen = seen(p);
+    return pSeen && !*pSeen;
+  };
+  for (std::size_t i = 0; i < spans.size(); i++) {
+    chunk& c = *spans[i].pChunk;
+    for (std::size_t j = 0; j < c.size; j++) {
+      if (spans[i].seen[j]) {
+        c.begin[j].n.drop_dependencies(freed_soon);
+        c.begin[j].data.drop_owners(freed_soon);
+      }
+    }
+  }
+
+  std::size_t freed = 0;
+  for (std::size_t i = 0; i < spans.size(); i++) {
+    chunk& c = *spans[i].pChunk;
+    for (std::size_t j = 0; j < c.size; j++) {
+      if (!spans[i].seen[j] && !c.isFree[j]) {
+        c.begin[j].~block();
+        c.isFree[j] = true;
+        freed++;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < arenas.size(); i++)
+    arenas[i]->compact();
+  return freed;
+}
+
+// node_arena::compact
+// . Gives back the chunks left with no nodes, and lists the free blocks of
+//   the others to be reused.
+void node_arena::compact() {
+  std::vector<chunk> chunks;
+  chunks.reserve(m_chunks.size());
+  for (std::size_t i = 0; i < m_chunks.size(); i++) {
+    chunk& c = m_chunks[i];
+    if (std::find(c.isFree.begin(), c.isFree.end(), false) == c.isFree.end())
+      ::operator delete(c.begin);
+    else
+      chunks.push_back(std::move(c));
+  }
+  m_chunks.swap(chunks);
+
+  // last first, so that create() reuses them in order
+  m_free.clear();
+  for (std::size_t i = m_chunks.size(); i-- > 0;) {
+    for (std::size_t j = m_chunks[i].size; j-- > 0;) {
+      if (m_chunks[i].isFree[j])
+        m_free.push_back(slot(i, j));
+    }
+  }
+}
 
 void memory_holder::merge(memory_holder& rhs) {
-  if (m_pMemory == rhs.m_pMemory)
+  memory& lhsMemory = get();
+  memory& rhsMemory = rhs.get();
+  if (&lhsMemory == &rhsMemory)
     return;
 
-  m_pMemory->merge(*rhs.m_pMemory);
+  lhsMemory.merge(rhsMemory);
+  rhsMemory.m_pForward = m_pMemory;
   rhs.m_pMemory = m_pMemory;
 }
 
+// keep
+// . Keeps the memory that now holds the nodes of 'rhs'. It may be read
+//   from other threads (it is frozen), so we don't compress its forward
+//   chain as get() does.
+void memory_holder::keep(const memory_holder& rhs) {
+  shared_memory pMemory = rhs.m_pMemory;
+  while (pMemory->m_pForward)
+    pMemory = pMemory->m_pForward;
+  get().keep(pMemory);
+}
+
 node& memory::create_node() {
-  shared_node pNode(new node);
-  m_nodes.insert(pNode);
-  return *pNode;
+  if (!m_pNodes)
+    m_pNodes.reset(new node_arena);
+  return m_pNodes->create();
 }
 
-void memory::merge(const memory& rhs) {
-  m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
+const std::string& memory::intern(const std::string& value) {
+  if (!m_pStrings)
+    m_pStrings.reset(new string_pool);
+  return m_pStrings->intern(value);
+}
+
+std::size_t memory::collect(node& root) {
+  std::vector<node_arena*> arenas;
+  if (m_pNodes)
+    arenas.push_back(m_pNodes.get());
+  for (Arenas::const_iterator it = m_mergedNodes.begin();
+       it != m_mergedNodes.end(); ++it)
+    arenas.push_back(it->get());
+  if (arenas.empty())
+    return 0;
+
+  const std::size_t freed = node_arena::collect(arenas, root);
+  for (Arenas::iterator it = m_mergedNodes.begin();
+       it != m_mergedNodes.end();) {
+    if ((*it)->empty())
+      it = m_mergedNodes.erase(it);
+    else
+      ++it;
+  }
+  return freed;
+}
+
+void memory::keep(const shared_memory& pMemory) {
+  if (pMemory.get() != this &&
+      std::find(m_kept.begin(), m_kept.end(), pMemory) == m_kept.end())
+    m_kept.push_back(pMemory);
+}
+
+void memory::merge(memory& rhs) {
+  if (rhs.m_pNodes)
+    m_mergedNodes.push_back(rhs.m_pNodes);
+  m_mergedNodes.splice(m_mergedNodes.end(), rhs.m_mergedNodes);
+  rhs.m_pNodes.reset();
+
+  if (rhs.m_pStrings)
+    m_mergedStrings.push_back(rhs.m_pStrings);
+  m_mergedStrings.splice(m_mergedStrings.end(), rhs.m_mergedStrings);
+  rhs.m_pStrings.reset();
+
+  // memory that forwards to this one (or is about to) mustn't be kept by
+  // it, or it would keep itself alive
+  m_kept.splice(m_kept.end(), rhs.m_kept);
+  for (Memories::iterator it = m_kept.begin(); it != m_kept.end();) {
+    const memory* pMemory = it->get();
+    while (pMemory->m_pForward)
+      pMemory = pMemory->m_pForward.get();
+    if (pMemory == this || pMemory == &rhs)
+      it = m_kept.erase(it);
+    else
+      ++it;
+  }
 }
 }
 }
@@ -0,0 +1,26 @@
+#ifndef MEMORYSTREAMBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define MEMORYSTREAMBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <streambuf>
+
+namespace YAML {
+// MemoryStreamBuf
+// . Read-only stream buffer over a range of memory that it does not own, so
+//   a slice of a loaded text can be parsed without copying it.
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  MemoryStreamBuf(const char* data, std::size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+}
+
+#endif  // MEMORYSTREAMBUF_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,7 +1,9 @@
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"
 #include "yaml-cpp/node/detail/node_data.h"
+#include "yaml-cpp/node/impl.h"
 
 #include "nodebuilder.h"
 #include "nodeevents.h"
@@ -14,6 +16,17 @@ Node Clone(const Node& node) {
   return builder.Root();
 }
 
+Node CloneShared(const Node& node) {
+  if (!node.IsFrozen() || !node.m_pMemory)
+    return Clone(node);
+
+  detail::shared_memory_holder pMemory(new detail::memory_holder);
+  pMemory->keep(*node.m_pMemory);
+  detail::node& root = pMemory->create_node();
+  root.share(*node.m_pNode);
+  return Node(root, pMemory);
+}
+
 const std::string& Node::Scalar() const {
     if (!m_isValid)
         throw InvalidNode();
@@ -1,6 +1,11 @@
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iterator>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
 
 #include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
@@ -13,24 +18,414 @@
 namespace YAML {
 namespace detail {
 
+namespace {
+// maps smaller than this are searched one key at a time
+const std::size_t MinIndexedMap = 8;
+
+void hash_combine(std::size_t& seed, std::size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}
+
+// key_index
+// . The positions of the scalar keys of a map, by their text; where several
+//   keys have the same text, the first one's, which a search through the
+//   entries would find.
+struct node_data::key_index {
+  struct hash {
+    std::size_t operator()(const std::string* key) const {
+      return std::hash<std::string>()(*key);
+    }
+  };
+  struct equal {
+    bool operator()(const std::string* lhs, const std::string* rhs) const {
+      return *lhs == *rhs;
+    }
+  };
+  typedef std::unordered_map<const std::string*, std::size_t, hash, equal>
+      Keys;
+
+  key_index() : duplicates(false) {}
+
+  // keys must be added in order
+  void add(const node& key, std::size_t pos) {
+    if (key.type() == NodeType::Scalar &&
+        !keys.insert(Keys::value_type(&key.scalar(), pos)).second)
+      duplicates = true;
+  }
+
+  // remove
+  // . Drops the key of the entry at 'pos'; false if another key with the
+  //   same text may be left, which only a rebuilt index would find.
+  bool remove(const node& key, std::size_t pos) {
+    if (key.type() != NodeType::Scalar)
+      return true;
+    Keys::iterator it = keys.find(&key.scalar());
+    if (it == keys.end() || it->second != pos)
+      return true;
+    if (duplicates)
+      return false;
+    keys.erase(it);
+    return true;
+  }
+
+  Keys keys;
+  bool duplicates;  // keys with the same text were added
+};
+
+node_data::owner_list::~owner_list() { delete many(); }
+
+node_data* const* node_data::owner_list::begin() const {
+  if (owners* pOwners = many())
+    return pOwners->data();
+  return &m_pOwner;
+}
+
+node_data* const* node_data::owner_list::end() const {
+  if (owners* pOwners = many())
+    return pOwners->data() + pOwners->size();
+  return m_pOwner ? &m_pOwner + 1 : &m_pOwner;
+}
+
+void node_data::owner_list::push_back(node_data* pOwner) {
+  if (owners* pOwners = many()) {
+    pOwners->push_back(pOwner);
+  } else if (!m_pOwner) {
+    m_pOwner = pOwner;
+  } else {
+    owners* pMany = new owners(1, m_pOwner);
+    pMany->push_back(pOwner);
+    m_pOwner = reinterpret_cast<node_data*>(
+        reinterpret_cast<std::uintptr_t>(pMany) + 1);
+  }
+}
+
 std::string node_data::empty_scalar;
 
+node_data::map_data::map_data() : removed(0) {}
+node_data::map_data::~map_data() {}
+
 node_data::node_data()
-    : m_isDefined(false),
-      m_mark(Mark::null_mark()),
+    : m_mark(Mark::null_mark()),
       m_type(NodeType::Null),
       m_style(EmitterStyle::Default),
-      m_seqSize(0) {}
+      m_isDefined(false),
+      m_isKey(false),
+      m_ownsTag(false),
+      m_isFrozen(false),
+      m_storage(NoStorage),
+      m_pTag(NULL),
+      m_pScalar(NULL),
+      m_pOwnedScalar(NULL) {}
+
+node_data::~node_data() {
+  // a shared node owns nothing, and its source may be gone by now
+  if (m_storage != SharedStorage)
+    set_storage(NoStorage);
+  if (m_ownsTag)
+    delete m_pTag;
+}
+
+// key_changed
+// . Called before a key changes, or is replaced: its maps' key indexes
+//   would be out of date. A frozen map's can't be, since its keys are
+//   frozen too, so a link left over from a map that has since been frozen
+//   is ignored.
+void node_data::key_changed() {
+  for (node_data* const* it = m_owners.begin(); it != m_owners.end(); ++it) {
+    node_data& owner = **it;
+    if (!owner.m_isFrozen && owner.m_storage == MapStorage)
+      owner.m_pMap->keyIndex.reset();
+  }
+}
+
+// add_owner
+// . Only the last link is checked for a repeat, which catches a node
+//   removed and inserted again, or added to one sequence many times; frozen
+//   nodes never change, and may be read by other threads, so they aren't
+//   linked.
+void node_data::add_owner(node_data& owner) {
+  if (m_isFrozen)
+    return;
+  node_data* const* last = m_owners.end();
+  if (last != m_owners.begin() && *(last - 1) == &owner)
+    return;
+  m_owners.push_back(&owner);
+}
+
+void node_data::replaced_by(node_data& rhs) {
+  owners_changed();
+  if (m_isKey) {
+    key_changed();
+    rhs.mark_key();
+  }
+  for (node_data* const* it = m_owners.begin(); it != m_owners.end(); ++it)
+    rhs.add_owner(**it);
+}
+
+// changed
+// . Called before this node changes, to drop the cached hash of its
+//   elements and of those of the sequences and maps up the tree that hold
+//   it (see owners_changed).
+void node_data::changed() {
+  drop_hash();
+  owners_changed();
+}
+
+// owners_changed
+// . Drops the cached hash of the nodes this one is linked to, and of theirs,
+//   and so on; a walk up stops at a frozen node, or one with no hash cached,
+//   since none of those above it can have one either: a hash is only cached
+//   once those of the elements under it are.
+void node_data::owners_changed() {
+  std::vector<node_data*> pending;
+  const owner_list* pOwners = &m_owners;
+  for (;;) {
+    for (node_data* const* it = pOwners->begin(); it != pOwners->end();
+         ++it) {
+      if (!(*it)->m_isFrozen && (*it)->drop_hash())
+        pending.push_back(*it);
+    }
+    if (pending.empty())
+      return;
+    pOwners = &pending.back()->m_owners;
+    pending.pop_back();
+  }
+}
+
+// drop_hash
+// . Drops the cached hash of the node's elements; false if it had none.
+bool node_data::drop_hash() {
+  hash_cache* pCache = NULL;
+  if (m_storage == SequenceStorage)
+    pCache = &m_pSequence->hash;
+  else if (m_storage == MapStorage)
+    pCache = &m_pMap->hash;
+  if (!pCache || !pCache->value.load(std::memory_order_relaxed))
+    return false;
+  pCache->value.store(0, std::memory_order_relaxed);
+  return true;
+}
+
+void node_data::throw_frozen() { throw FrozenNode(); }
+
+void node_data::freeze(std::vector<node*>& nodes) {
+  if (m_isFrozen)
+    return;
+
+  // a shared node's elements are its source's, which are frozen already
+  if (m_storage == SharedStorage) {
+    m_isFrozen = true;
+    return;
+  }
+
+  switch (m_isDefined ? m_type : NodeType::Undefined) {
+    case NodeType::Sequence:
+      push_children(nodes);
+      break;
+    case NodeType::Map:
+      push_children(nodes);
+      if (m_pMap->removed)
+        compact_map();
+      if (entries().size() >= MinIndexedMap && !m_pMap->keyIndex)
+        index_keys();
+      break;
+    default:
+      break;
+  }
+  m_isFrozen = true;
+}
+
+// push_children
+// . Whatever the node's type, since a node set to null keeps its old
+//   elements until it is given new ones.
+void node_data::push_children(std::vector<node*>& nodes) const {
+  switch (m_storage) {
+    case SequenceStorage:
+      nodes.insert(nodes.end(), m_pSequence->nodes.begin(),
+                   m_pSequence->nodes.end());
+      break;
+    case MapStorage:
+      for (node_map::const_iterator it = m_pMap->entries.begin();
+           it != m_pMap->entries.end(); ++it) {
+        if (!it->first)
+          continue;
+        nodes.push_back(it->first);
+        nodes.push_back(it->second);
+      }
+      break;
+    case SharedStorage:
+      nodes.push_back(m_pSource);
+      break;
+    default:
+      break;
+  }
+}
+
+void node_data::share(node& source) {
+  const node_data& data = *source.ref()->data();
+  m_mark = data.m_mark;
+  m_type = data.m_type;
+  m_style = data.m_style;
+  m_isDefined = data.m_isDefined;
+  if (data.m_ownsTag)
+    set_tag(*data.m_pTag);
+  else
+    m_pTag = data.m_pTag;
+
+  // an interned scalar (or none) needs nothing from the source
+  m_pScalar = data.m_pScalar;
+  if (data.m_storage != NoStorage) {
+    m_pSource = &source;
+    m_storage = SharedStorage;
+  }
+}
+
+void node_data::unshare(shared_memory_holder pMemory,
+                        std::vector<node*>& undefined) {
+  if (m_isFrozen || !pMemory || !shared_elements())
+    return;
+
+  const node_data& source = shared_source();
+  switch (m_type) {
+    case NodeType::Sequence: {
+      const node_seq& elements = source.sequence();
+      reset_sequence();
+      sequence().reserve(elements.size());
+      for (std::size_t i = 0; i < elements.size(); i++) {
+        node& element = pMemory->create_node();
+        element.share(*elements[i]);
+        element.add_owner(*this);
+        sequence().push_back(&element);
+        if (!element.is_defined())
+          undefined.push_back(&element);
+      }
+      update_size();
+      // the elements are still the source's, and so is their hash
+      m_pSequence->hash.value.store(source.m_pSequence->hash.value);
+      break;
+    }
+    case NodeType::Map: {
+      const node_map& map = source.entries();
+      reset_map();
+      entries().reserve(map.size());
+      for (std::size_t i = 0; i < map.size(); i++) {
+        if (!map[i].first)
+          continue;
+        node& key = pMemory->create_node();
+        key.share(*map[i].first);
+        node& value = pMemory->create_node();
+        value.share(*map[i].second);
+        insert_map_pair(key, value);
+        if (!key.is_defined())
+          undefined.push_back(&key);
+        if (!value.is_defined())
+          undefined.push_back(&value);
+      }
+      m_pMap->hash.value.store(source.m_pMap->hash.value);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// shared_elements
+// . The node whose elements a shared sequence or map reads in place of its
+//   own; NULL if it has its own (or isn't one).
+node* node_data::shared_elements() const {
+  if (m_storage != SharedStorage)
+    return NULL;
+  return m_type == NodeType::Sequence || m_type == NodeType::Map ? m_pSource
+                                                                  : NULL;
+}
+
+// shared_source
+// . The data that a shared node's source (or its source's, and so on)
+//   actually holds.
+const node_data& node_data::shared_source() const {
+  const node_data* pData = this;
+  while (pData->m_storage == SharedStorage)
+    pData = pData->m_pSource->ref()->data();
+  return *pData;
+}
+
+std::size_t node_data::hash() const {
+  const NodeType::value type = this->type();
+  std::size_t seed = static_cast<std::size_t>(type);
+  if (!is_nonspecific(tag()))
+    hash_combine(seed, std::hash<std::string>()(tag()));
+  switch (type) {
+    case NodeType::Scalar:
+      hash_combine(seed, std::hash<std::string>()(scalar()));
+      break;
+    case NodeType::Sequence:
+    case NodeType::Map:
+      hash_combine(seed, elements_hash());
+      break;
+    default:
+      break;
+  }
+  return seed;
+}
+
+std::size_t node_data::elements_hash() const {
+  if (node* pSource = shared_elements())
+    return pSource->ref()->data()->elements_hash();
+
+  hash_cache& cache =
+      m_type == NodeType::Sequence ? m_pSequence->hash : m_pMap->hash;
+  std::size_t value = cache.value;
+  if (value)
+    return value;
+
+  // the elements are those the node's iterators go through
+  value = 0;
+  std::size_t count = 0;
+  if (m_type == NodeType::Sequence) {
+    for (; count < sequence().size(); count++)
+      hash_combine(value, sequence()[count]->hash());
+  } else {
+    // entries are summed, so their order doesn't matter
+    for (node_map::const_iterator it = entries().begin();
+         it != entries().end(); ++it) {
+      if (!it->first || !it->first->is_defined() || !it->second->is_defined())
+        continue;
+      std::size_t entry = it->first->hash();
+      hash_combine(entry, it->second->hash());
+      value += entry;
+      count++;
+    }
+  }
+  hash_combine(value, count);
+  if (value == 0)
+    value = 1;
+
+  cache.value = value;
+  return value;
+}
 
 void node_data::mark_defined() {
+  if (m_isDefined)
+    return;
+  check_mutable();
+  changed();
   if (m_type == NodeType::Undefined)
     m_type = NodeType::Null;
   m_isDefined = true;
 }
 
-void node_data::set_mark(const Mark& mark) { m_mark = mark; }
+void node_data::set_mark(const Mark& mark) {
+  check_mutable();
+  m_mark = mark;
+}
 
 void node_data::set_type(NodeType::value type) {
+  check_mutable();
+  changed();
+  if (m_isKey)
+    key_changed();
+
   if (type == NodeType::Undefined) {
     m_type = type;
     m_isDefined = false;
@@ -47,7 +442,7 @@ void node_data::set_type(NodeType::value type) {
     case NodeType::Null:
       break;
     case NodeType::Scalar:
-      m_scalar.clear();
+      m_pScalar = NULL;
       break;
     case NodeType::Sequence:
       reset_sequence();
@@ -61,105 +456,204 @@ void node_data::set_type(NodeType::value type) {
   }
 }
 
-void node_data::set_tag(const std::string& tag) { m_tag = tag; }
+void node_data::set_tag(const std::string& tag) {
+  check_mutable();
+  changed();
+  if (m_ownsTag) {
+    *const_cast<std::string*>(m_pTag) = tag;
+  } else {
+    m_pTag = new std::string(tag);
+    m_ownsTag = true;
+  }
+}
+
+// set_interned_tag
+// . Like set_tag, but refers to a string owned by the node's memory (see
+//   memory::intern); a document only has a handful of distinct tags.
+void node_data::set_interned_tag(const std::string& tag) {
+  check_mutable();
+  changed();
+  if (m_ownsTag)
+    delete m_pTag;
+  m_ownsTag = false;
+  m_pTag = &tag;
+}
 
-void node_data::set_style(EmitterStyle::value style) { m_style = style; }
+void node_data::set_style(EmitterStyle::value style) {
+  check_mutable();
+  m_style = static_cast<unsigned char>(style);
+}
 
 void node_data::set_null() {
+  check_mutable();
+  changed();
+  if (m_isKey)
+    key_changed();
   m_isDefined = true;
   m_type = NodeType::Null;
 }
 
 void node_data::set_scalar(const std::string& scalar) {
+  check_mutable();
+  changed();
+  if (m_isKey)
+    key_changed();
   m_isDefined = true;
   m_type = NodeType::Scalar;
-  m_scalar = scalar;
+  if (m_storage == ScalarStorage) {
+    *m_pOwnedScalar = scalar;
+  } else {
+    set_storage(NoStorage);
+    m_pOwnedScalar = new std::string(scalar);
+    m_storage = ScalarStorage;
+  }
+  m_pScalar = m_pOwnedScalar;
+}
+
+void node_data::set_scalar(std::string&& scalar) {
+  check_mutable();
+  changed();
+  if (m_isKey)
+    key_changed();
+  m_isDefined = true;
+  m_type = NodeType::Scalar;
+  if (m_storage == ScalarStorage) {
+    *m_pOwnedScalar = std::move(scalar);
+  } else {
+    set_storage(NoStorage);
+    m_pOwnedScalar = new std::string(std::move(scalar));
+    m_storage = ScalarStorage;
+  }
+  m_pScalar = m_pOwnedScalar;
+}
+
+// set_interned_scalar
+// . Like set_scalar, but refers to a string owned by the node's memory (see
+//   memory::intern) instead of copying it.
+void node_data::set_interned_scalar(const std::string& scalar) {
+  check_mutable();
+  changed();
+  if (m_isKey)
+    key_changed();
+  m_isDefined = true;
+  m_type = NodeType::Scalar;
+  set_storage(NoStorage);
+  m_pScalar = &scalar;
 }
 
 // size/iterator
 std::size_t node_data::size() const {
   if (!m_isDefined)
     return 0;
+  if (node* pSource = shared_elements())
+    return pSource->size();
 
   switch (m_type) {
     case NodeType::Sequence:
-      compute_seq_size();
-      return m_seqSize;
+      return m_pSequence->definedSize;
     case NodeType::Map:
-      compute_map_size();
-      return m_map.size() - m_undefinedPairs.size();
+      return m_pMap->entries.size() - m_pMap->removed -
+             m_pMap->undefinedPairs.size();
     default:
       return 0;
   }
   return 0;
 }
 
-void node_data::compute_seq_size() const {
-  while (m_seqSize < m_sequence.size() && m_sequence[m_seqSize]->is_defined())
-    m_seqSize++;
-}
-
-void node_data::compute_map_size() const {
-  kv_pairs::iterator it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
-    kv_pairs::iterator jt = std::next(it);
-    if (it->first->is_defined() && it->second->is_defined())
-      m_undefinedPairs.erase(it);
-    it = jt;
+// update_size
+// . Counts the elements that have become defined: a sequence's size is its
+//   defined prefix, and a map's leaves out the pairs still waiting on their
+//   key or value. Called as elements are added, and (through
+//   node::child_defined) when one of them is defined, so size() only reads
+//   the counts.
+void node_data::update_size() {
+  check_mutable();
+  if (m_storage == SharedStorage)
+    return;
+  changed();
+  switch (m_type) {
+    case NodeType::Sequence: {
+      std::size_t& definedSize = m_pSequence->definedSize;
+      while (definedSize < sequence().size() &&
+             sequence()[definedSize]->is_defined())
+        definedSize++;
+      break;
+    }
+    case NodeType::Map: {
+      kv_pairs& undefinedPairs = m_pMap->undefinedPairs;
+      kv_pairs::iterator it = undefinedPairs.begin();
+      while (it != undefinedPairs.end()) {
+        if (it->first->is_defined() && it->second->is_defined())
+          it = undefinedPairs.erase(it);
+        else
+          ++it;
+      }
+      break;
+    }
+    default:
+      break;
   }
 }
 
 const_node_iterator node_data::begin() const {
+  if (node* pSource = shared_elements())
+    return static_cast<const node&>(*pSource).begin();
   if (!m_isDefined)
     return const_node_iterator();
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.begin());
+      return const_node_iterator(sequence().begin());
     case NodeType::Map:
-      return const_node_iterator(m_map.begin(), m_map.end());
+      return const_node_iterator(entries().begin(), entries().end());
     default:
       return const_node_iterator();
   }
 }
 
 node_iterator node_data::begin() {
+  if (node* pSource = shared_elements())
+    return pSource->begin();
   if (!m_isDefined)
     return node_iterator();
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.begin());
+      return node_iterator(sequence().begin());
     case NodeType::Map:
-      return node_iterator(m_map.begin(), m_map.end());
+      return node_iterator(entries().begin(), entries().end());
     default:
       return node_iterator();
   }
 }
 
 const_node_iterator node_data::end() const {
+  if (node* pSource = shared_elements())
+    return static_cast<const node&>(*pSource).end();
   if (!m_isDefined)
     return const_node_iterator();
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.end());
+      return const_node_iterator(sequence().end());
     case NodeType::Map:
-      return const_node_iterator(m_map.end(), m_map.end());
+      return const_node_iterator(entries().end(), entries().end());
     default:
       return const_node_iterator();
   }
 }
 
 node_iterator node_data::end() {
+  if (node* pSource = shared_elements())
+    return pSource->end();
   if (!m_isDefined)
     return node_iterator();
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.end());
+      return node_iterator(sequence().end());
     case NodeType::Map:
-      return node_iterator(m_map.end(), m_map.end());
+      return node_iterator(entries().end(), entries().end());
     default:
       return node_iterator();
   }
@@ -167,6 +661,7 @@ node_iterator node_data::end() {
 
 // sequence
 void node_data::push_back(node& node, shared_memory_holder /* pMemory */) {
+  check_mutable();
   if (m_type == NodeType::Undefined || m_type == NodeType::Null) {
     m_type = NodeType::Sequence;
     reset_sequence();
@@ -175,10 +670,13 @@ void node_data::push_back(node& node, shared_memory_holder /* pMemory */) {
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
-  m_sequence.push_back(&node);
+  node.add_owner(*this);
+  sequence().push_back(&node);
+  update_size();
 }
 
 void node_data::insert(node& key, node& value, shared_memory_holder pMemory) {
+  check_mutable();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -194,14 +692,56 @@ void node_data::insert(node& key, node& value, shared_memory_holder pMemory) {
   insert_map_pair(key, value);
 }
 
+void node_data::append(const node_data& rhs) {
+  check_mutable();
+  assert(m_type == rhs.m_type && rhs.m_storage != SharedStorage);
+  changed();
+  switch (m_type) {
+    case NodeType::Sequence: {
+      const node_seq& elements = rhs.sequence();
+      sequence().reserve(sequence().size() + elements.size());
+      for (std::size_t i = 0; i < elements.size(); i++) {
+        elements[i]->add_owner(*this);
+        sequence().push_back(elements[i]);
+      }
+      update_size();
+      break;
+    }
+    case NodeType::Map: {
+      const node_map& map = rhs.entries();
+      entries().reserve(entries().size() + map.size() - rhs.m_pMap->removed);
+      for (std::size_t i = 0; i < map.size(); i++) {
+        if (!map[i].first)
+          continue;
+        node& key = *map[i].first;
+        node& value = *map[i].second;
+        key.mark_key();
+        key.add_owner(*this);
+        value.add_owner(*this);
+        entries().push_back(map[i]);
+        if (key_index* pIndex = m_pMap->keyIndex.get())
+          pIndex->add(key, entries().size() - 1);
+        if (!key.is_defined() || !value.is_defined())
+          m_pMap->undefinedPairs.push_back(map[i]);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 // indexing
-node* node_data::get(node& key, shared_memory_holder /* pMemory */) const {
+node* node_data::get(node& key, shared_memory_holder pMemory) const {
+  if (node* pSource = shared_elements())
+    return static_cast<const node&>(*pSource).get(key, pMemory);
   if (m_type != NodeType::Map) {
     return NULL;
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->is(key))
+  for (node_map::const_iterator it = entries().begin(); it != entries().end();
+       ++it) {
+    if (it->first && it->first->is(key))
       return it->second;
   }
 
@@ -209,6 +749,7 @@ node* node_data::get(node& key, shared_memory_holder /* pMemory */) const {
 }
 
 node& node_data::get(node& key, shared_memory_holder pMemory) {
+  check_mutable();
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -221,8 +762,9 @@ node& node_data::get(node& key, shared_memory_holder pMemory) {
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->is(key))
+  for (node_map::const_iterator it = entries().begin(); it != entries().end();
+       ++it) {
+    if (it->first && it->first->is(key))
       return *it->second;
   }
 
@@ -232,12 +774,13 @@ node& node_data::get(node& key, shared_memory_holder pMemory) {
 }
 
 bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
+  check_mutable();
   if (m_type != NodeType::Map)
     return false;
 
-  for (node_map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->is(key)) {
-      m_map.erase(it);
+  for (std::size_t i = 0; i < entries().size(); i++) {
+    if (entries()[i].first && entries()[i].first->is(key)) {
+      erase_pair(i);
       return true;
     }
   }
@@ -245,23 +788,180 @@ bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
   return false;
 }
 
-void node_data::reset_sequence() {
-  m_sequence.clear();
-  m_seqSize = 0;
-}
+// set_storage
+// . Frees what the node owns for its old type, and starts empty storage of
+//   the given kind.
+void node_data::set_storage(storage_type storage) {
+  switch (m_storage) {
+    case SharedStorage: {
+      const node_data& source = shared_source();
+      if (source.m_storage == ScalarStorage &&
+          m_pScalar == source.m_pOwnedScalar)
+        m_pScalar = NULL;
+      break;
+    }
+    case ScalarStorage:
+      if (m_pScalar == m_pOwnedScalar)
+        m_pScalar = NULL;
+      delete m_pOwnedScalar;
+      break;
+    case SequenceStorage:
+      delete m_pSequence;
+      break;
+    case MapStorage:
+      delete m_pMap;
+      break;
+    default:
+      break;
+  }
 
-void node_data::reset_map() {
-  m_map.clear();
-  m_undefinedPairs.clear();
+  m_pOwnedScalar = NULL;
+  switch (storage) {
+    case ScalarStorage:
+      m_pOwnedScalar = new std::string;
+      break;
+    case SequenceStorage:
+      m_pSequence = new sequence_data;
+      break;
+    case MapStorage:
+      m_pMap = new map_data;
+      break;
+    default:
+      break;
+  }
+  m_storage = static_cast<unsigned char>(storage);
 }
 
+void node_data::reset_sequence() { set_storage(SequenceStorage); }
+
+void node_data::reset_map() { set_storage(MapStorage); }
+
 void node_data::insert_map_pair(node& key, node& value) {
-  m_map[&key] = &value;
+  changed();
+  const std::size_t pos = find_entry(key);
+  if (pos < entries().size()) {
+    kv_pair& entry = entries()[pos];
+    m_pMap->undefinedPairs.remove(entry);
+    entry.second = &value;
+  } else {
+    key.mark_key();
+    key.add_owner(*this);
+    entries().push_back(kv_pair(&key, &value));
+    if (key_index* pIndex = m_pMap->keyIndex.get())
+      pIndex->add(key, entries().size() - 1);
+  }
+  value.add_owner(*this);
+
   if (!key.is_defined() || !value.is_defined())
-    m_undefinedPairs.push_back(kv_pair(&key, &value));
+    m_pMap->undefinedPairs.push_back(kv_pair(&key, &value));
+}
+
+// find_entry
+// . The position of the entry whose key is the node 'key', which keeps its
+//   place with a new value, or entries().size(). A key that isn't frozen is
+//   linked to the maps it is in (see add_owner), so most are ruled out
+//   without a look at the entries; a scalar one is then looked up by its
+//   text, which only finds the first of several keys with the same text.
+std::size_t node_data::find_entry(const node& key) const {
+  const node_map& map = entries();
+  const node_data& data = *key.ref()->data();
+  if (!data.m_isKey)
+    return map.size();
+  const owner_list& owners = data.m_owners;
+  if (!data.m_isFrozen &&
+      std::find(owners.begin(), owners.end(), this) == owners.end())
+    return map.size();
+
+  if (map.size() >= MinIndexedMap && key.type() == NodeType::Scalar) {
+    const std::size_t pos = find_key(key.scalar());
+    if (pos < map.size() && map[pos].first == &key)
+      return pos;
+    if (!m_pMap->keyIndex->duplicates)
+      return map.size();
+  }
+
+  for (std::size_t i = 0; i < map.size(); i++) {
+    if (map[i].first == &key)
+      return i;
+  }
+  return map.size();
+}
+
+// find_key
+// . The position of the entry whose key's scalar is 'key', as a search with
+//   equals<std::string> would find it, or entries().size(). Big maps keep an
+//   index for it, kept up to date as keys are inserted and removed, and
+//   rebuilt if one of their keys has changed (see key_changed) or the
+//   entries were compacted.
+std::size_t node_data::find_key(const std::string& key) const {
+  const node_map& map = entries();
+  if (map.size() < MinIndexedMap) {
+    for (std::size_t i = 0; i < map.size(); i++) {
+      const node* k = map[i].first;
+      if (k && k->type() == NodeType::Scalar && k->scalar() == key)
+        return i;
+    }
+    return map.size();
+  }
+
+  // a frozen map's index was built by freeze, and its keys can't change
+  const std::unique_ptr<key_index>& keyIndex = m_pMap->keyIndex;
+  if (!keyIndex)
+    index_keys();
+
+  key_index::Keys::const_iterator it = keyIndex->keys.find(&key);
+  return it != keyIndex->keys.end() ? it->second : map.size();
+}
+
+void node_data::index_keys() const {
+  const node_map& map = entries();
+  std::unique_ptr<key_index>& keyIndex = m_pMap->keyIndex;
+  keyIndex.reset(new key_index);
+  keyIndex->keys.reserve(map.size());
+  for (std::size_t i = 0; i < map.size(); i++) {
+    if (map[i].first)
+      keyIndex->add(*map[i].first, i);
+  }
+}
+
+// erase_pair
+// . Empties the entry's slot (leaving a null pair, which iterators and
+//   searches skip) rather than moving the entries after it, so the key index
+//   stays good but for this key; the slots are compacted once most of them
+//   are empty.
+void node_data::erase_pair(std::size_t pos) {
+  changed();
+  node_map& map = entries();
+  const kv_pair pair = map[pos];
+  m_pMap->undefinedPairs.remove(pair);
+  map[pos] = kv_pair(NULL, NULL);
+  m_pMap->removed++;
+
+  std::unique_ptr<key_index>& keyIndex = m_pMap->keyIndex;
+  if (keyIndex && !keyIndex->remove(*pair.first, pos))
+    keyIndex.reset();
+
+  while (!map.empty() && !map.back().first) {
+    map.pop_back();
+    m_pMap->removed--;
+  }
+  if (2 * m_pMap->removed > map.size())
+    compact_map();
+}
+
+// compact_map
+// . Drops the empty slots of removed entries; the others move, so the key
+//   index is rebuilt on the next lookup.
+void node_data::compact_map() {
+  node_map& map = entries();
+  map.erase(std::remove(map.begin(), map.end(), kv_pair(NULL, NULL)),
+            map.end());
+  m_pMap->removed = 0;
+  m_pMap->keyIndex.reset();
 }
 
 void node_data::convert_to_map(shared_memory_holder pMemory) {
+  changed();
   switch (m_type) {
     case NodeType::Undefined:
     case NodeType::Null:
@@ -282,18 +982,36 @@ void node_data::convert_to_map(shared_memory_holder pMemory) {
 void node_data::convert_sequence_to_map(shared_memory_holder pMemory) {
   assert(m_type == NodeType::Sequence);
 
+  node_seq sequence;
+  sequence.swap(this->sequence());
   reset_map();
-  for (std::size_t i = 0; i < m_sequence.size(); i++) {
+  for (std::size_t i = 0; i < sequence.size(); i++) {
     std::stringstream stream;
     stream << i;
 
     node& key = pMemory->create_node();
     key.set_scalar(stream.str());
-    insert_map_pair(key, *m_sequence[i]);
+    insert_map_pair(key, *sequence[i]);
   }
 
-  reset_sequence();
   m_type = NodeType::Map;
 }
+
+// convert_to_node
+// . A string becomes a scalar made in pMemory itself, rather than in a Node
+//   (and memory) of its own that is then merged in; an rvalue is moved.
+node& node_data::convert_to_node(const std::string& rhs,
+                                 shared_memory_holder pMemory) {
+  node& value = pMemory->create_node();
+  value.set_scalar(rhs);
+  return value;
+}
+
+node& node_data::convert_to_node(std::string&& rhs,
+                                 shared_memory_holder pMemory) {
+  node& value = pMemory->create_node();
+  value.set_scalar(std::move(rhs));
+  return value;
+}
 }
 }
@@ -6,12 +6,17 @@
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/type.h"
+#include "yaml-cpp/parser.h"
 
 namespace YAML {
 struct Mark;
 
-NodeBuilder::NodeBuilder()
-    : m_pMemory(new detail::memory_holder), m_pRoot(0), m_mapDepth(0) {
+NodeBuilder::NodeBuilder(bool internScalars)
+    : m_pMemory(new detail::memory_holder),
+      m_pRoot(0),
+      m_internScalars(internScalars),
+      m_pLastTag(NULL),
+      m_mapDepth(0) {
   m_anchors.push_back(0);  // since the anchors start at 1
 }
 
@@ -24,6 +29,15 @@ Node NodeBuilder::Root() {
   return Node(*m_pRoot, m_pMemory);
 }
 
+bool NodeBuilder::HandleNextDocument(Parser& parser) {
+  return parser.HandleNextDocument(*this);
+}
+
+void NodeBuilder::Append(Node& to, const Node& from) {
+  to.m_pMemory->merge(*from.m_pMemory);
+  to.m_pNode->append(*from.m_pNode, to.m_pMemory);
+}
+
 void NodeBuilder::OnDocumentStart(const Mark&) {}
 
 void NodeBuilder::OnDocumentEnd() {}
@@ -43,8 +57,11 @@ void NodeBuilder::OnAlias(const Mark& /* mark */, anchor_t anchor) {
 void NodeBuilder::OnScalar(const Mark& mark, const std::string& tag,
                            anchor_t anchor, const std::string& value) {
   detail::node& node = Push(mark, anchor);
-  node.set_scalar(value);
-  node.set_tag(tag);
+  if (m_internScalars)
+    node.set_interned_scalar(m_pMemory->intern(value));
+  else
+    node.set_scalar(value);
+  node.set_interned_tag(InternTag(tag));
   Pop();
 }
 
@@ -52,7 +69,7 @@ void NodeBuilder::OnSequenceStart(const Mark& mark,
                                   const std::string& tag, anchor_t anchor,
                                   EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
-  node.set_tag(tag);
+  node.set_interned_tag(InternTag(tag));
   node.set_type(NodeType::Sequence);
   node.set_style(style);
 }
@@ -63,7 +80,7 @@ void NodeBuilder::OnMapStart(const Mark& mark, const std::string& tag,
                              anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
   node.set_type(NodeType::Map);
-  node.set_tag(tag);
+  node.set_interned_tag(InternTag(tag));
   node.set_style(style);
   m_mapDepth++;
 }
@@ -106,12 +123,12 @@ void NodeBuilder::Pop() {
   detail::node& collection = *m_stack.back();
 
   if (collection.type() == NodeType::Sequence) {
-    collection.push_back(node, m_pMemory);
+    collection.push_back_defined(node, m_pMemory);
   } else if (collection.type() == NodeType::Map) {
     assert(!m_keys.empty());
     PushedKey& key = m_keys.back();
     if (key.second) {
-      collection.insert(*key.first, node, m_pMemory);
+      collection.insert_defined(*key.first, node, m_pMemory);
       m_keys.pop_back();
     } else {
       key.second = true;
@@ -128,4 +145,13 @@ void NodeBuilder::RegisterAnchor(anchor_t anchor, detail::node& node) {
     m_anchors.push_back(&node);
   }
 }
+
+// InternTag
+// . Tags are stored once per document; runs of nodes with the same tag (as
+//   is usual) only compare it with the last one.
+const std::string& NodeBuilder::InternTag(const std::string& tag) {
+  if (!m_pLastTag || *m_pLastTag != tag)
+    m_pLastTag = &m_pMemory->intern(tag);
+  return *m_pLastTag;
+}
 }
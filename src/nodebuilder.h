@@ -23,14 +23,29 @@ struct Mark;
 
 namespace YAML {
 class Node;
+class Parser;
 
-class NodeBuilder : public EventHandler {
+// final, so that the parser's calls to it (see SingleDocParser) are bound
+// statically and can be inlined
+class NodeBuilder final : public EventHandler {
  public:
-  NodeBuilder();
+  explicit NodeBuilder(bool internScalars = false);
   virtual ~NodeBuilder();
 
   Node Root();
 
+  // HandleNextDocument
+  // . Builds the next document of 'parser', as parser.HandleNextDocument
+  //   would, but with the parser's calls to this builder bound statically.
+  bool HandleNextDocument(Parser& parser);
+
+  // Append
+  // . Adds the elements of 'from' after those of 'to', both sequences or
+  //   both maps made by builders (see Loader::LoadParallel), in one step:
+  //   the keys of 'from' can't be keys of 'to' already, so its entries are
+  //   appended as they are. 'to' takes over the memory of 'from'.
+  static void Append(Node& to, const Node& from);
+
   virtual void OnDocumentStart(const Mark& mark);
   virtual void OnDocumentEnd();
 
@@ -52,10 +67,13 @@ class NodeBuilder : public EventHandler {
   void Push(detail::node& node);
   void Pop();
   void RegisterAnchor(anchor_t anchor, detail::node& node);
+  const std::string& InternTag(const std::string& tag);
 
  private:
   detail::shared_memory_holder m_pMemory;
   detail::node* m_pRoot;
+  bool m_internScalars;
+  const std::string* m_pLastTag;
 
   typedef std::vector<detail::node*> Nodes;
   Nodes m_stack;
@@ -0,0 +1,251 @@
+#include "yaml-cpp/node/parse.h"
+
+#include <fstream>
+#include <thread>
+
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "nodebuilder.h"
+#include "textchunk.h"
+#include "threadpool.h"
+
+namespace YAML {
+namespace {
+// thrown by a worker when its chunk doesn't parse to what the split expected
+struct SplitMismatch {};
+
+// SplitDocuments
+// . Cuts the text into chunks of whole documents: a chunk starts at every
+//   column-0 "---" and right after every column-0 "..." line, which is where
+//   the scanner ends a document (even inside a block scalar).
+// . Returns false if the stream can't be split this way: it isn't UTF-8, or
+//   it has directives, which carry over to the following documents.
+bool SplitDocuments(const std::string& text, std::vector<TextChunk>& chunks) {
+  std::size_t bom;
+  if (!CheckEncoding(text, bom))
+    return false;
+
+  TextChunk chunk = MakeChunk(text, bom, bom, bom, 0);
+  int line = 0;
+  for (std::size_t i = bom; i < text.size(); line++) {
+    std::size_t next = NextLine(text, i);
+
+    std::size_t split = std::string::npos;
+    int splitLine = line;
+    if (text[i] == '%') {
+      return false;
+    } else if (IsDocIndicator(text, i, '-')) {
+      split = i;
+    } else if (IsDocIndicator(text, i, '.')) {
+      split = next;
+      splitLine = line + 1;
+    }
+
+    if (split != std::string::npos && split > chunk.begin &&
+        split < text.size()) {
+      chunk.end = split;
+      chunks.push_back(chunk);
+      chunk = MakeChunk(text, split, split, bom, splitLine);
+    }
+    i = next;
+  }
+
+  chunk.end = text.size();
+  if (chunk.end > chunk.begin)
+    chunks.push_back(chunk);
+  return true;
+}
+
+// SplitEntries
+// . Cuts a single document whose root is a block sequence or block map into
+//   chunks of at least 'target' bytes, each starting at a line that begins a
+//   top-level entry: a "- " (sequence) or a key (map) at the root's
+//   indentation. For a map root, "- " lines at that indentation belong to the
+//   previous key's value and don't start an entry.
+// . Returns false if the text doesn't look like such a document; a wrong
+//   guess only costs a fallback, since every chunk is checked once parsed.
+bool SplitEntries(const std::string& text, std::size_t target,
+                  std::vector<TextChunk>& chunks, NodeType::value& rootType) {
+  std::size_t bom;
+  if (!CheckEncoding(text, bom))
+    return false;
+
+  TextChunk chunk = MakeChunk(text, bom, bom, bom, 0);
+  std::size_t indent = std::string::npos;
+  int line = 0;
+  for (std::size_t i = bom; i < text.size(); line++) {
+    std::size_t next = NextLine(text, i);
+
+    std::size_t j = i;
+    while (j < next && text[j] == ' ')
+      j++;
+    if (j < next && text[j] == '\t')
+      return false;
+
+    if (IsEmptyLine(text, j)) {
+      i = next;
+      continue;
+    }
+
+    if (j == i) {
+      if (text[i] == '%')
+        return false;
+      if (IsDocIndicator(text, i, '-') || IsDocIndicator(text, i, '.')) {
+        // only a bare "---" in front of the root is allowed
+        if (indent != std::string::npos || text[i] != '-' ||
+            !IsEmptyLine(text, i + 3))
+          return false;
+        i = next;
+        continue;
+      }
+    }
+
+    const char ch = text[j];
+    const bool entry = (ch == '-' && IsBlankOrBreak(text, j + 1));
+    if (indent == std::string::npos) {
+      // the root's first entry; it stays in the first chunk
+      switch (ch) {
+        case '[':
+        case '{':
+        case '&':
+        case '!':
+        case '*':
+        case '|':
+        case '>':
+        case '?':
+        case ':':
+          return false;
+        default:
+          break;
+      }
+      indent = j - i;
+      rootType = entry ? NodeType::Sequence : NodeType::Map;
+      i = next;
+      continue;
+    }
+
+    const std::size_t column = j - i;
+    if (column < indent)
+      return false;
+    if (column == indent) {
+      if (rootType == NodeType::Sequence && !entry)
+        return false;
+      if (rootType == NodeType::Map && (ch == '?' || ch == ':'))
+        return false;
+
+      const bool split = (rootType == NodeType::Sequence || !entry);
+      if (split && i - chunk.begin >= target) {
+        chunk.end = i;
+        chunks.push_back(chunk);
+        chunk = MakeChunk(text, i, i, bom, line);
+      }
+    }
+    i = next;
+  }
+
+  chunk.end = text.size();
+  chunks.push_back(chunk);
+  return indent != std::string::npos;
+}
+
+}
+
+std::vector<Node> Loader::LoadAllParallel(const std::string& input) {
+  std::vector<TextChunk> chunks;
+  if (!SplitDocuments(input, chunks) || chunks.size() < 2)
+    return LoadAll(input);
+
+  std::vector<std::vector<Node> > results(chunks.size());
+  try {
+    ParallelFor(chunks.size(), m_threads, [&](std::size_t i) {
+      ParseChunk(input, chunks[i], m_textEnabled, m_internScalars, m_maxDepth,
+                 results[i]);
+    });
+  } catch (const Exception&) {
+    // a chunk may fail differently than the whole stream would (e.g. a quoted
+    // scalar that runs into a "---" line), so report the error LoadAll gives
+    return LoadAll(input);
+  }
+
+  std::vector<Node> docs;
+  for (std::size_t i = 0; i < results.size(); i++)
+    docs.insert(docs.end(), results[i].begin(), results[i].end());
+  if (m_freeze) {
+    for (std::size_t i = 0; i < docs.size(); i++)
+      docs[i].Freeze();
+  }
+  return docs;
+}
+
+std::vector<Node> Loader::LoadAllParallel(const char* input) {
+  return LoadAllParallel(std::string(input));
+}
+
+std::vector<Node> Loader::LoadAllParallel(std::istream& input) {
+  return LoadAllParallel(ReadAll(input));
+}
+
+std::vector<Node> Loader::LoadAllFromFileParallel(const std::string& filename) {
+  std::ifstream fin(filename.c_str(), std::ios::binary);
+  if (!fin)
+    throw BadFile();
+  return LoadAllParallel(fin);
+}
+
+Node Loader::LoadParallel(const std::string& input) {
+  unsigned threads =
+      m_threads ? m_threads : std::thread::hardware_concurrency();
+  // a few chunks per thread keeps them busy when entries differ in size
+  std::size_t target = input.size() / (4 * (threads ? threads : 1)) + 1;
+
+  std::vector<TextChunk> chunks;
+  NodeType::value rootType = NodeType::Undefined;
+  if (!SplitEntries(input, target, chunks, rootType) || chunks.size() < 2)
+    return Load(input);
+
+  std::vector<Node> roots(chunks.size());
+  try {
+    ParallelFor(chunks.size(), m_threads, [&](std::size_t i) {
+      std::vector<Node> docs;
+      ParseChunk(input, chunks[i], m_textEnabled, m_internScalars, m_maxDepth,
+                 docs);
+      if (docs.size() != 1 || docs[0].Type() != rootType ||
+          docs[0].Style() != EmitterStyle::Block)
+        throw SplitMismatch();
+      roots[i] = docs[0];
+    });
+  } catch (const Exception&) {
+    // e.g. an alias to an anchor in another chunk, or a flow collection that
+    // spans a split point; the serial parse decides what it really is
+    return Load(input);
+  } catch (const SplitMismatch&) {
+    return Load(input);
+  }
+
+  // the first chunk's root has the right mark, tag and style; the entries of
+  // the others are appended to it, which also takes over their memory
+  Node root = roots[0];
+  for (std::size_t i = 1; i < roots.size(); i++)
+    NodeBuilder::Append(root, roots[i]);
+  if (m_freeze)
+    root.Freeze();
+  return root;
+}
+
+Node Loader::LoadParallel(const char* input) {
+  return LoadParallel(std::string(input));
+}
+
+Node Loader::LoadParallel(std::istream& input) {
+  return LoadParallel(ReadAll(input));
+}
+
+Node Loader::LoadFileParallel(const std::string& filename) {
+  std::ifstream fin(filename.c_str(), std::ios::binary);
+  if (!fin)
+    throw BadFile();
+  return LoadParallel(fin);
+}
+}
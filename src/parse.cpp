@@ -7,8 +7,12 @@
 
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/eventtape.h"
 #include "yaml-cpp/parser.h"
+#include "filecache.h"
+#include "memorystreambuf.h"
 #include "nodebuilder.h"
+#include "textchunk.h"
 
 #include <iostream>
 #include <algorithm>
@@ -136,18 +140,45 @@ Node Loader::Load(const char* input) {
 
 Node Loader::Load(std::istream& input) {
     m_parser->Load(input, m_textEnabled);
-    NodeBuilder builder;
-    if (!m_parser->HandleNextDocument(builder))
+    m_parser->SetMaxDepth(m_maxDepth);
+    NodeBuilder builder(m_internScalars);
+    if (!builder.HandleNextDocument(*m_parser))
         return Node();
 
-    return builder.Root();
+    Node root = builder.Root();
+    if (m_freeze)
+        root.Freeze();
+    return root;
 }
 
 Node Loader::LoadFile(const std::string& filename) {
-  std::ifstream fin(filename.c_str());
+  // binary either way, so a cached parse sees the same bytes (and gives the
+  // same scalars and marks) as an uncached one, as LoadFileParallel does
+  std::ifstream fin(filename.c_str(), std::ios::binary);
   if (!fin)
     throw BadFile();
-  return Load(fin);
+  if (!m_useCache)
+    return Load(fin);
+
+  const std::string text = ReadAll(fin);
+
+  const std::string cachePath = CachePath(filename, m_cacheDir);
+  EventTape tape;
+  if (!ReadCache(cachePath, text, tape)) {
+    MemoryStreamBuf buffer(text.data(), text.size());
+    std::istream stream(&buffer);
+    m_parser->Load(stream, m_textEnabled);
+    m_parser->SetMaxDepth(m_maxDepth);
+    m_parser->HandleNextDocument(tape);
+    WriteCache(cachePath, text, tape);
+  }
+
+  NodeBuilder builder(m_internScalars);
+  tape.Replay(builder, m_maxDepth);
+  Node root = builder.Root();
+  if (m_freeze)
+    root.Freeze();
+  return root;
 }
 
 std::vector<Node> Loader::LoadAll(const std::string& input) {
@@ -163,12 +194,15 @@ std::vector<Node> Loader::LoadAll(const char* input) {
 std::vector<Node> Loader::LoadAll(std::istream& input) {
     std::vector<Node> docs;
     m_parser->Load(input, m_textEnabled);
+    m_parser->SetMaxDepth(m_maxDepth);
 
     while (1) {
-        NodeBuilder builder;
-        if (!m_parser->HandleNextDocument(builder))
+        NodeBuilder builder(m_internScalars);
+        if (!builder.HandleNextDocument(*m_parser))
         break;
         docs.push_back(builder.Root());
+        if (m_freeze)
+            docs.back().Freeze();
     }
 
     return docs;
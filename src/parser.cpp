@@ -5,15 +5,73 @@
 #include "scanner.h"     // IWYU pragma: keep
 #include "singledocparser.h"
 #include "token.h"
+#include "yaml-cpp/event.h"
+#include "yaml-cpp/vieweventhandler.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
-class EventHandler;
+namespace {
+// copies a single event into an Event
+class EventRecorder : public ViewEventHandler {
+ public:
+  explicit EventRecorder(Event& event) : m_event(event) {}
 
-Parser::Parser() {}
+  virtual void OnDocumentStart(const Mark& mark) {
+    Set(EventType::DocumentStart, mark);
+  }
+  virtual void OnDocumentEnd() { Set(EventType::DocumentEnd, Mark()); }
+
+  virtual void OnNull(const Mark& mark, anchor_t anchor) {
+    Set(EventType::Null, mark, anchor);
+  }
+  virtual void OnAlias(const Mark& mark, anchor_t anchor) {
+    Set(EventType::Alias, mark, anchor);
+  }
+  virtual void OnScalarView(const Mark& mark, const StringView& tag,
+                            anchor_t anchor, const StringView& value) {
+    Set(EventType::Scalar, mark, anchor);
+    m_event.tag.assign(tag.data(), tag.size());
+    m_event.value.assign(value.data(), value.size());
+  }
+
+  virtual void OnSequenceStartView(const Mark& mark, const StringView& tag,
+                                   anchor_t anchor,
+                                   EmitterStyle::value style) {
+    Set(EventType::SequenceStart, mark, anchor);
+    m_event.tag.assign(tag.data(), tag.size());
+    m_event.style = style;
+  }
+  virtual void OnSequenceEnd() { Set(EventType::SequenceEnd, Mark()); }
+
+  virtual void OnMapStartView(const Mark& mark, const StringView& tag,
+                              anchor_t anchor, EmitterStyle::value style) {
+    Set(EventType::MapStart, mark, anchor);
+    m_event.tag.assign(tag.data(), tag.size());
+    m_event.style = style;
+  }
+  virtual void OnMapEnd() { Set(EventType::MapEnd, Mark()); }
 
-Parser::Parser(std::istream& in, bool textEnabled) { Load(in, textEnabled); }
+ private:
+  void Set(EventType::value type, const Mark& mark,
+           anchor_t anchor = NullAnchor) {
+    m_event.type = type;
+    m_event.mark = mark;
+    m_event.tag.clear();
+    m_event.anchor = anchor;
+    m_event.value.clear();
+    m_event.style = EmitterStyle::Default;
+  }
+
+  Event& m_event;
+};
+}
+
+Parser::Parser() : m_maxDepth(0) {}
+
+Parser::Parser(std::istream& in, bool textEnabled) : m_maxDepth(0) {
+  Load(in, textEnabled);
+}
 
 Parser::~Parser() {}
 
@@ -21,32 +79,116 @@ Parser::operator bool() const {
   return m_pScanner.get() && !m_pScanner->empty();
 }
 
-void Parser::Load(std::istream& in, bool textEnabled) {
-  m_pScanner.reset(new Scanner(in, textEnabled));
+void Parser::Load(std::istream& in, bool textEnabled, const Mark& start) {
+  m_pScanner.reset(new Scanner(in, textEnabled, start));
   m_pDirectives.reset(new Directives);
+  m_pDocument.reset();
 }
 
+void Parser::SetMaxDepth(std::size_t maxDepth) { m_maxDepth = maxDepth; }
+
 std::string Parser::GetText() const {
     return m_pScanner->text();
 }
 
+// CurrentDocument
+// . The unfinished document, or else the next one, started after its
+//   directives; NULL at the end of the stream.
+SingleDocParser* Parser::CurrentDocument() {
+  if (!m_pScanner.get())
+    return NULL;
+
+  if (!m_pDocument) {
+    ParseDirectives();
+    if (m_pScanner->empty())
+      return NULL;
+    m_pDocument.reset(
+        new SingleDocParser(*m_pScanner, *m_pDirectives, m_maxDepth));
+  }
+  return m_pDocument.get();
+}
+
 // HandleNextDocument
-// . Handles the next document
+// . Handles the next document (or the rest of an unfinished one)
 // . Throws a ParserException on error.
 // . Returns false if there are no more documents
-bool Parser::HandleNextDocument(EventHandler& eventHandler) {
-  if (!m_pScanner.get())
+// . If the handler stops parsing, returns right away and leaves the document
+//   unfinished.
+// . A document that an exception escapes from is dropped: it stopped halfway
+//   through a step, so it can't be resumed.
+bool Parser::HandleNextDocument(ViewEventHandler& eventHandler) {
+  SingleDocParser* pDocument = CurrentDocument();
+  if (!pDocument)
     return false;
 
-  ParseDirectives();
-  if (m_pScanner->empty())
+  bool finished;
+  try {
+    finished = pDocument->HandleDocument(eventHandler);
+  } catch (...) {
+    m_pDocument.reset();
+    throw;
+  }
+  if (finished)
+    m_pDocument.reset();
+  return true;
+}
+
+bool Parser::HandleNextDocument(NodeBuilder& builder) {
+  SingleDocParser* pDocument = CurrentDocument();
+  if (!pDocument)
     return false;
 
-  SingleDocParser sdp(*m_pScanner, *m_pDirectives);
-  sdp.HandleDocument(eventHandler);
+  bool finished;
+  try {
+    finished = pDocument->HandleDocument(builder);
+  } catch (...) {
+    m_pDocument.reset();
+    throw;
+  }
+  if (finished)
+    m_pDocument.reset();
+  return true;
+}
+
+bool Parser::NextEvent(Event& event) {
+  SingleDocParser* pDocument = CurrentDocument();
+  if (!pDocument)
+    return false;
+
+  EventRecorder recorder(event);
+  try {
+    pDocument->HandleNextEvent(recorder);
+  } catch (...) {
+    m_pDocument.reset();  // as in HandleNextDocument
+    throw;
+  }
+  if (event.type == EventType::DocumentEnd)
+    m_pDocument.reset();
   return true;
 }
 
+bool Parser::InDocument() const { return m_pDocument.get() != NULL; }
+
+void Parser::SkipDocument() {
+  if (!m_pDocument)
+    return;
+  m_pDocument.reset();
+
+  // a document only ends at a "---" or "..." (or the end of the stream)
+  while (!m_pScanner->empty()) {
+    Token::TYPE type = m_pScanner->peek().type;
+    if (type == Token::DOC_START)
+      break;
+    m_pScanner->pop();
+    if (type == Token::DOC_END)
+      break;
+  }
+
+  // and eat any doc ends we see, as SingleDocParser does
+  while (!m_pScanner->empty() && m_pScanner->peek().type == Token::DOC_END)
+    m_pScanner->pop();
+}
+
 // ParseDirectives
 // . Reads any directives that are next in the queue.
 void Parser::ParseDirectives() {
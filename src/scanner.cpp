@@ -7,8 +7,8 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
-Scanner::Scanner(std::istream& in, bool textEnabled)
-    : INPUT(in, textEnabled),
+Scanner::Scanner(std::istream& in, bool textEnabled, const Mark& start)
+    : INPUT(in, textEnabled, start),
       m_startedStream(false),
       m_endedStream(false),
       m_simpleKeyAllowed(false),
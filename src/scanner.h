@@ -26,7 +26,8 @@ class RegEx;
 
 class Scanner {
  public:
-  Scanner(std::istream &in, bool textEnabled = false);
+  Scanner(std::istream &in, bool textEnabled = false,
+          const Mark &start = Mark());
   ~Scanner();
 
   // token queue management (hopefully this looks kinda stl-ish)
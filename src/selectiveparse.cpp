@@ -0,0 +1,560 @@
+#include "yaml-cpp/node/parse.h"
+
+#include <fstream>
+
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/node.h"
+#include "textchunk.h"
+
+namespace YAML {
+namespace {
+typedef std::vector<std::string> Path;
+
+// thrown by the text walk at anything it can't skip over on its own
+struct NotSkippable {};
+
+// SplitPath
+// . "a.*.b" -> { "a", "*", "b" }; an empty path matches the whole document.
+Path SplitPath(const std::string& path) {
+  Path segments;
+  if (path.empty())
+    return segments;
+
+  std::size_t begin = 0;
+  while (1) {
+    std::size_t dot = path.find('.', begin);
+    if (dot == std::string::npos) {
+      segments.push_back(path.substr(begin));
+      return segments;
+    }
+    segments.push_back(path.substr(begin, dot - begin));
+    begin = dot + 1;
+  }
+}
+
+// the paths still in play at some node, each with the number of its
+// segments that matched on the way there
+class PathSet {
+ public:
+  PathSet() {}
+  explicit PathSet(const std::vector<Path>& paths) {
+    for (std::size_t i = 0; i < paths.size(); i++)
+      m_paths.push_back(Entry(&paths[i], 0));
+  }
+
+  bool empty() const { return m_paths.empty(); }
+
+  // true if some path ends here, so the whole node is wanted
+  bool Complete() const {
+    for (std::size_t i = 0; i < m_paths.size(); i++) {
+      if (m_paths[i].second == m_paths[i].first->size())
+        return true;
+    }
+    return false;
+  }
+
+  // the paths that go on below the entry 'key' (a map key or a sequence index)
+  PathSet Next(const std::string& key) const {
+    PathSet next;
+    for (std::size_t i = 0; i < m_paths.size(); i++) {
+      const Path& path = *m_paths[i].first;
+      const std::size_t matched = m_paths[i].second;
+      if (matched < path.size() &&
+          (path[matched] == "*" || path[matched] == key))
+        next.m_paths.push_back(Entry(&path, matched + 1));
+    }
+    return next;
+  }
+
+ private:
+  typedef std::pair<const Path*, std::size_t> Entry;
+  std::vector<Entry> m_paths;
+};
+
+// Select
+// . Keeps the parts of an already loaded node matched by 'paths'; returns
+//   false if there are none.
+bool Select(const Node& node, const PathSet& paths, Node& result) {
+  if (paths.Complete()) {
+    result.reset(node);
+    return true;
+  }
+
+  bool matched = false;
+  if (node.IsMap()) {
+    Node map(NodeType::Map);
+    for (const_iterator it = node.begin(); it != node.end(); ++it) {
+      if (!it->first.IsScalar())
+        continue;
+      PathSet next = paths.Next(it->first.Scalar());
+      Node value;
+      if (!next.empty() && Select(it->second, next, value)) {
+        map.force_insert(it->first, value);
+        matched = true;
+      }
+    }
+    if (matched)
+      result.reset(map);
+  } else if (node.IsSequence()) {
+    Node sequence(NodeType::Sequence);
+    for (std::size_t i = 0; i < node.size(); i++) {
+      PathSet next = paths.Next(std::to_string(i));
+      Node entry;
+      if (!next.empty() && Select(node[i], next, entry)) {
+        sequence.push_back(entry);
+        matched = true;
+      }
+    }
+    if (matched)
+      result.reset(sequence);
+  }
+  return matched;
+}
+
+// SelectiveWalk
+// . Follows the block structure of a document in the raw text, a line at a
+//   time, and only parses the values some path wants. Everything else is
+//   skipped by its indentation, or, for a flow collection or a quoted scalar
+//   that may run over less indented lines, by balancing its brackets and
+//   quotes.
+// . Throws NotSkippable at anything else (complex keys, tabs, an indented or
+//   flow root, directives...), which is left to the full parse.
+class SelectiveWalk {
+ public:
+  SelectiveWalk(const std::string& text, std::size_t bom, bool textEnabled,
+                bool internScalars, std::size_t maxDepth)
+      : m_text(text),
+        m_end(text.size()),
+        m_bom(bom),
+        m_textEnabled(textEnabled),
+        m_internScalars(internScalars),
+        m_maxDepth(maxDepth) {}
+
+  bool WalkDocument(const PathSet& paths, Node& result) {
+    if (paths.Complete())
+      throw NotSkippable();
+
+    bool started = false;
+    for (Cursor c = {m_bom, 0}; c.pos < m_end; c = NextLine(c)) {
+      if (m_text[c.pos] == '%')
+        throw NotSkippable();
+      if (IsDocIndicator(m_text, c.pos, '-')) {
+        if (started || !IsEmptyLine(m_text, c.pos + 3))
+          throw NotSkippable();
+        started = true;
+        continue;
+      }
+      if (IsDocIndicator(m_text, c.pos, '.'))
+        return false;
+
+      std::size_t content = Indentation(c.pos);
+      if (IsEmptyLine(m_text, content))
+        continue;
+      if (content != c.pos)
+        throw NotSkippable();
+      if (IsEntry(c.pos))
+        return WalkSequence(c, m_end, paths, result);
+      std::string key;
+      Cursor value;
+      if (ParseKey(c, key, value))
+        return WalkMap(c, m_end, paths, result);
+      throw NotSkippable();
+    }
+    return false;
+  }
+
+ private:
+  // a position in the text and the line it is on
+  struct Cursor {
+    std::size_t pos;
+    int line;
+  };
+
+  Cursor NextLine(Cursor c) const {
+    Cursor next = {YAML::NextLine(m_text, c.pos), c.line + 1};
+    return next;
+  }
+
+  std::size_t Column(std::size_t pos) const {
+    std::size_t newline = (pos == 0 ? std::string::npos
+                                    : m_text.rfind('\n', pos - 1));
+    return pos - (newline == std::string::npos ? m_bom : newline + 1);
+  }
+
+  // Indentation
+  // . Returns the first character after the spaces at the start of a line.
+  std::size_t Indentation(std::size_t lineStart) const {
+    std::size_t i = lineStart;
+    while (i < m_text.size() && m_text[i] == ' ')
+      i++;
+    if (i < m_text.size() && m_text[i] == '\t' && !IsEmptyLine(m_text, i))
+      throw NotSkippable();
+    return i;
+  }
+
+  bool IsEntry(std::size_t i) const {
+    return m_text[i] == '-' && IsBlankOrBreak(m_text, i + 1);
+  }
+
+  // SkipLines
+  // . Skips from a line start over the empty lines and those indented more
+  //   than 'indent' (and, if 'entries', the "- " lines at 'indent', which
+  //   belong to a map value); stops at the first other line, or at the end
+  //   of the document.
+  Cursor SkipLines(Cursor c, std::size_t indent, bool entries) {
+    for (; c.pos < m_end; c = NextLine(c)) {
+      std::size_t content = Indentation(c.pos);
+      if (IsEmptyLine(m_text, content))
+        continue;
+
+      std::size_t column = content - c.pos;
+      if (column == 0 && (IsDocIndicator(m_text, c.pos, '-') ||
+                          IsDocIndicator(m_text, c.pos, '.'))) {
+        m_end = c.pos;
+        break;
+      }
+      if (column < indent ||
+          (column == indent && !(entries && IsEntry(content))))
+        break;
+    }
+    return c;
+  }
+
+  // SkipQuoted
+  // . Skips a quoted scalar, from its opening quote to past its closing one.
+  Cursor SkipQuoted(Cursor c) const {
+    const char quote = m_text[c.pos];
+    for (c.pos++; c.pos < m_end; c.pos++) {
+      const char ch = m_text[c.pos];
+      if (ch == '\n') {
+        c.line++;
+      } else if (quote == '"' && ch == '\\') {
+        if (c.pos + 1 < m_end && m_text[c.pos + 1] == '\n')
+          c.line++;
+        c.pos++;
+      } else if (ch == quote) {
+        if (quote == '\'' && c.pos + 1 < m_end && m_text[c.pos + 1] == '\'') {
+          c.pos++;
+          continue;
+        }
+        c.pos++;
+        return c;
+      }
+    }
+    throw NotSkippable();
+  }
+
+  // SkipFlow
+  // . Skips a flow collection by balancing its brackets.
+  Cursor SkipFlow(Cursor c) const {
+    int depth = 0;
+    while (c.pos < m_end) {
+      const char ch = m_text[c.pos];
+      const char prev = (c.pos == 0 ? '\n' : m_text[c.pos - 1]);
+      const bool afterBlank =
+          (prev == ' ' || prev == '\t' || prev == '\n' || prev == '\r');
+      if ((ch == '"' || ch == '\'') &&
+          (afterBlank || prev == '[' || prev == '{' || prev == ',' ||
+           prev == ':')) {
+        c = SkipQuoted(c);
+        continue;
+      }
+      if (ch == '#' && afterBlank) {
+        c.pos = m_text.find('\n', c.pos);
+        if (c.pos == std::string::npos)
+          c.pos = m_text.size();
+        continue;
+      }
+
+      if (ch == '\n') {
+        c.line++;
+      } else if (ch == '[' || ch == '{') {
+        depth++;
+      } else if (ch == ']' || ch == '}') {
+        if (--depth == 0) {
+          c.pos++;
+          return c;
+        }
+      }
+      c.pos++;
+    }
+    throw NotSkippable();
+  }
+
+  // SkipValue
+  // . Skips a value that starts at 'c' on the line of its key or "- ".
+  Cursor SkipValue(Cursor c, std::size_t indent) {
+    const char ch = m_text[c.pos];
+    if (ch == '[' || ch == '{')
+      c = SkipFlow(c);
+    else if (ch == '"' || ch == '\'')
+      c = SkipQuoted(c);
+    return SkipLines(NextLine(c), indent, false);
+  }
+
+  // ParseKey
+  // . If a block map key starts at 'c', reads it and sets 'value' to the
+  //   first character after its ':' and the blanks that follow.
+  bool ParseKey(Cursor c, std::string& key, Cursor& value) const {
+    std::size_t i = c.pos;
+    const char first = m_text[i];
+    if (first == '"' || first == '\'') {
+      Cursor end = SkipQuoted(c);
+      if (end.line != c.line)
+        return false;
+      key = m_text.substr(c.pos + 1, end.pos - c.pos - 2);
+      if (first == '"' && key.find('\\') != std::string::npos)
+        throw NotSkippable();
+      for (std::size_t quote = key.find("''"); quote != std::string::npos;
+           quote = key.find("''", quote + 1))
+        key.erase(quote, 1);
+
+      i = end.pos;
+      while (i < m_end && (m_text[i] == ' ' || m_text[i] == '\t'))
+        i++;
+      if (i == m_end || m_text[i] != ':' || !IsBlankOrBreak(m_text, i + 1))
+        return false;
+    } else {
+      switch (first) {
+        case '[':
+        case '{':
+        case '&':
+        case '!':
+        case '*':
+        case '|':
+        case '>':
+        case '?':
+        case ':':
+        case '%':
+        case '@':
+        case '`':
+          return false;
+        default:
+          if (IsEntry(i))
+            return false;
+          break;
+      }
+
+      for (; i < m_end && m_text[i] != '\n'; i++) {
+        if (m_text[i] == ':' && IsBlankOrBreak(m_text, i + 1))
+          break;
+        if (m_text[i] == '#' && i > c.pos &&
+            (m_text[i - 1] == ' ' || m_text[i - 1] == '\t'))
+          return false;
+      }
+      if (i == m_end || m_text[i] != ':')
+        return false;
+
+      std::size_t keyEnd = i;
+      while (keyEnd > c.pos &&
+             (m_text[keyEnd - 1] == ' ' || m_text[keyEnd - 1] == '\t'))
+        keyEnd--;
+      key = m_text.substr(c.pos, keyEnd - c.pos);
+    }
+
+    i++;
+    while (i < m_end && (m_text[i] == ' ' || m_text[i] == '\t'))
+      i++;
+    value.pos = i;
+    value.line = c.line;
+    return true;
+  }
+
+  // Extract
+  // . Parses the text from 'begin' to 'end' and keeps what 'paths' match.
+  bool Extract(Cursor begin, std::size_t end, const PathSet& paths,
+               Node& result) const {
+    std::vector<Node> docs;
+    ParseChunk(m_text, MakeChunk(m_text, begin.pos, end, m_bom, begin.line),
+               m_textEnabled, m_internScalars, m_maxDepth, docs);
+    if (docs.size() > 1)
+      throw NotSkippable();
+    return Select(docs.empty() ? Node(NodeType::Null) : docs[0], paths,
+                  result);
+  }
+
+  // WalkNode
+  // . Walks a node that starts at 'c', on the line of its key or "- ".
+  bool WalkNode(Cursor c, std::size_t end, const PathSet& paths,
+                Node& result) {
+    if (paths.Complete())
+      return Extract(c, end, paths, result);
+    if (IsEntry(c.pos))
+      return WalkSequence(c, end, paths, result);
+    std::string key;
+    Cursor value;
+    if (ParseKey(c, key, value))
+      return WalkMap(c, end, paths, result);
+    return Extract(c, end, paths, result);
+  }
+
+  // WalkBlock
+  // . Walks a node that starts on the line after its key or "- ".
+  bool WalkBlock(Cursor c, std::size_t end, const PathSet& paths,
+                 Node& result) {
+    if (paths.Complete())
+      return Extract(c, end, paths, result);
+    for (; c.pos < end; c = NextLine(c)) {
+      std::size_t content = Indentation(c.pos);
+      if (!IsEmptyLine(m_text, content)) {
+        Cursor start = {content, c.line};
+        return WalkNode(start, end, paths, result);
+      }
+    }
+    return false;
+  }
+
+  bool WalkMap(Cursor c, std::size_t end, const PathSet& paths,
+               Node& result) {
+    const std::size_t indent = Column(c.pos);
+    Node map(NodeType::Map);
+    bool matched = false;
+    while (1) {
+      std::string key;
+      Cursor value;
+      if (!ParseKey(c, key, value))
+        throw NotSkippable();
+
+      const bool inlineValue = !IsEmptyLine(m_text, value.pos);
+      Cursor next = inlineValue ? SkipValue(value, indent)
+                                : SkipLines(NextLine(value), indent, true);
+      if (next.pos > end)
+        throw NotSkippable();
+
+      PathSet keyPaths = paths.Next(key);
+      if (!keyPaths.empty()) {
+        Node sub;
+        bool found =
+            inlineValue ? Extract(value, next.pos, keyPaths, sub)
+                        : WalkBlock(NextLine(value), next.pos, keyPaths, sub);
+        if (found) {
+          map.force_insert(key, sub);
+          matched = true;
+        }
+      }
+
+      c = next;
+      if (c.pos >= end || c.pos >= m_end)
+        break;
+      std::size_t content = Indentation(c.pos);
+      if (content - c.pos < indent)
+        break;
+      if (content - c.pos > indent || IsEntry(content))
+        throw NotSkippable();
+      c.pos = content;
+    }
+
+    if (matched)
+      result.reset(map);
+    return matched;
+  }
+
+  bool WalkSequence(Cursor c, std::size_t end, const PathSet& paths,
+                    Node& result) {
+    const std::size_t indent = Column(c.pos);
+    Node sequence(NodeType::Sequence);
+    bool matched = false;
+    for (std::size_t index = 0;; index++) {
+      Cursor content = c;
+      content.pos++;
+      while (content.pos < m_end &&
+             (m_text[content.pos] == ' ' || m_text[content.pos] == '\t'))
+        content.pos++;
+
+      const bool inlineContent = !IsEmptyLine(m_text, content.pos);
+      Cursor next = inlineContent ? SkipValue(content, indent)
+                                  : SkipLines(NextLine(content), indent, false);
+      if (next.pos > end)
+        throw NotSkippable();
+
+      PathSet entryPaths = paths.Next(std::to_string(index));
+      if (!entryPaths.empty()) {
+        Node sub;
+        bool found =
+            inlineContent
+                ? WalkNode(content, next.pos, entryPaths, sub)
+                : WalkBlock(NextLine(content), next.pos, entryPaths, sub);
+        if (found) {
+          sequence.push_back(sub);
+          matched = true;
+        }
+      }
+
+      c = next;
+      if (c.pos >= end || c.pos >= m_end)
+        break;
+      std::size_t start = Indentation(c.pos);
+      if (start - c.pos < indent)
+        break;
+      if (start - c.pos > indent || !IsEntry(start))
+        throw NotSkippable();
+      c.pos = start;
+    }
+
+    if (matched)
+      result.reset(sequence);
+    return matched;
+  }
+
+  const std::string& m_text;
+  std::size_t m_end;  // shrinks to the end of the document once it's seen
+  std::size_t m_bom;
+  bool m_textEnabled;
+  bool m_internScalars;
+  std::size_t m_maxDepth;
+};
+}
+
+Node Loader::LoadSelected(const std::string& input,
+                          const std::vector<std::string>& paths) {
+  std::vector<Path> split;
+  for (std::size_t i = 0; i < paths.size(); i++)
+    split.push_back(SplitPath(paths[i]));
+  PathSet pathSet(split);
+
+  std::size_t bom;
+  if (CheckEncoding(input, bom)) {
+    try {
+      SelectiveWalk walk(input, bom, m_textEnabled, m_internScalars,
+                         m_maxDepth);
+      Node result;
+      if (!walk.WalkDocument(pathSet, result))
+        return Node();
+      if (m_freeze)
+        result.Freeze();
+      return result;
+    } catch (const NotSkippable&) {
+    } catch (const Exception&) {
+      // e.g. an alias to an anchor that was skipped; the full parse decides
+    }
+  }
+
+  Node result;
+  if (!Select(Load(input), pathSet, result))
+    return Node();
+  if (m_freeze)
+    result.Freeze();
+  return result;
+}
+
+Node Loader::LoadSelected(const char* input,
+                          const std::vector<std::string>& paths) {
+  return LoadSelected(std::string(input), paths);
+}
+
+Node Loader::LoadSelected(std::istream& input,
+                          const std::vector<std::string>& paths) {
+  return LoadSelected(ReadAll(input), paths);
+}
+
+Node Loader::LoadFileSelected(const std::string& filename,
+                              const std::vector<std::string>& paths) {
+  std::ifstream fin(filename.c_str(), std::ios::binary);
+  if (!fin)
+    throw BadFile();
+  return LoadSelected(fin, paths);
+}
+}
@@ -5,46 +5,105 @@
 #include "collectionstack.h"  // IWYU pragma: keep
 #include "scanner.h"
 #include "singledocparser.h"
+#include "nodebuilder.h"
 #include "tag.h"
 #include "token.h"
 #include "yaml-cpp/emitterstyle.h"
-#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/vieweventhandler.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
-SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives)
+namespace {
+// the non-specific tags, given to nodes with no tag of their own
+const std::string UnresolvedTag = "?";
+const std::string NonPlainTag = "!";
+}
+
+SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives,
+                                 std::size_t maxDepth)
     : m_scanner(scanner),
       m_directives(directives),
+      m_maxDepth(maxDepth),
       m_pCollectionStack(new CollectionStack),
-      m_curAnchor(0) {}
+      m_curAnchor(0),
+      m_started(false) {}
 
 SingleDocParser::~SingleDocParser() {}
 
 // HandleDocument
-// . Handles the next document
+// . Handles the rest of the document
 // . Throws a ParserException on error.
-void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
-  assert(!m_scanner.empty());  // guaranteed that there are tokens
-  assert(!m_curAnchor);
+// . Returns false if the handler stopped parsing before the end; the parser
+//   can pick up from there later.
+bool SingleDocParser::HandleDocument(ViewEventHandler& eventHandler) {
+  return HandleEvents(eventHandler);
+}
 
-  eventHandler.OnDocumentStart(m_scanner.peek().mark);
+bool SingleDocParser::HandleDocument(NodeBuilder& builder) {
+  return HandleEvents(builder);
+}
 
-  // eat doc start
-  if (m_scanner.peek().type == Token::DOC_START)
-    m_scanner.pop();
+bool SingleDocParser::HandleNextEvent(ViewEventHandler& eventHandler) {
+  return Step(eventHandler);
+}
 
-  // recurse!
-  HandleNode(eventHandler);
+template <typename Handler>
+bool SingleDocParser::HandleEvents(Handler& eventHandler) {
+  while (Step(eventHandler)) {
+    if (eventHandler.TakeStopRequest())
+      return m_frames.empty();
+  }
+  return true;
+}
 
-  eventHandler.OnDocumentEnd();
+// Step
+// . Steps the innermost open collection until it hands out an event; some
+//   steps (like eating a flow separator) don't.
+template <typename Handler>
+bool SingleDocParser::Step(Handler& eventHandler) {
+  if (!m_started) {
+    assert(!m_scanner.empty());  // guaranteed that there are tokens
+    m_started = true;
+    PushFrame(Frame::Document);
+  }
 
-  // and finally eat any doc ends we see
-  while (!m_scanner.empty() && m_scanner.peek().type == Token::DOC_END)
-    m_scanner.pop();
+  while (!m_frames.empty()) {
+    bool handled = false;
+    switch (m_frames.back().kind) {
+      case Frame::Document:
+        handled = StepDocument(eventHandler);
+        break;
+      case Frame::BlockSeq:
+        handled = StepBlockSequence(eventHandler);
+        break;
+      case Frame::FlowSeq:
+        handled = StepFlowSequence(eventHandler);
+        break;
+      case Frame::BlockMap:
+        handled = StepBlockMap(eventHandler);
+        break;
+      case Frame::FlowMap:
+        handled = StepFlowMap(eventHandler);
+        break;
+      case Frame::CompactMap:
+        handled = StepCompactMap(eventHandler);
+        break;
+      case Frame::CompactMapWithNoKey:
+        handled = StepCompactMapWithNoKey(eventHandler);
+        break;
+    }
+    if (handled)
+      return true;
+  }
+  return false;
 }
 
-void SingleDocParser::HandleNode(EventHandler& eventHandler) {
+// StartNode
+// . Hands out the first event of a node; a collection is pushed as a frame,
+//   and its entries come in the following steps.
+template <typename Handler>
+void SingleDocParser::StartNode(Handler& eventHandler) {
   // an empty node *is* a possibility
   if (m_scanner.empty()) {
     eventHandler.OnNull(m_scanner.mark(), NullAnchor);
@@ -56,9 +115,9 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
 
   // special case: a value node by itself must be a map, with no header
   if (m_scanner.peek().type == Token::VALUE) {
-    eventHandler.OnMapStart(mark, "?", NullAnchor, EmitterStyle::Default);
-    HandleMap(eventHandler);
-    eventHandler.OnMapEnd();
+    eventHandler.OnMapStartView(mark, UnresolvedTag, NullAnchor,
+                                EmitterStyle::Default);
+    PushFrame(Frame::CompactMapWithNoKey);
     return;
   }
 
@@ -69,9 +128,9 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
     return;
   }
 
-  std::string tag;
+  const std::string* pTag;
   anchor_t anchor;
-  ParseProperties(tag, anchor);
+  ParseProperties(pTag, anchor);
 
   const Token& token = m_scanner.peek();
 
@@ -82,43 +141,40 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   }
 
   // add non-specific tags
-  if (tag.empty())
-    tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
+  if (!pTag || pTag->empty())
+    pTag = (token.type == Token::NON_PLAIN_SCALAR ? &NonPlainTag
+                                                  : &UnresolvedTag);
+  const std::string& tag = *pTag;
 
   // now split based on what kind of node we should be
   switch (token.type) {
     case Token::PLAIN_SCALAR:
     case Token::NON_PLAIN_SCALAR:
-      eventHandler.OnScalar(mark, tag, anchor, token.value);
+      eventHandler.OnScalarView(mark, tag, anchor, token.value);
       m_scanner.pop();
       return;
     case Token::FLOW_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      eventHandler.OnSequenceStartView(mark, tag, anchor, EmitterStyle::Flow);
+      PushFrame(Frame::FlowSeq);
       return;
     case Token::BLOCK_SEQ_START:
-      eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      eventHandler.OnSequenceStartView(mark, tag, anchor, EmitterStyle::Block);
+      PushFrame(Frame::BlockSeq);
       return;
     case Token::FLOW_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      eventHandler.OnMapStartView(mark, tag, anchor, EmitterStyle::Flow);
+      PushFrame(Frame::FlowMap);
       return;
     case Token::BLOCK_MAP_START:
-      eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      eventHandler.OnMapStartView(mark, tag, anchor, EmitterStyle::Block);
+      PushFrame(Frame::BlockMap);
       return;
     case Token::KEY:
       // compact maps can only go in a flow sequence
       if (m_pCollectionStack->GetCurCollectionType() ==
           CollectionType::FlowSeq) {
-        eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-        HandleMap(eventHandler);
-        eventHandler.OnMapEnd();
+        eventHandler.OnMapStartView(mark, tag, anchor, EmitterStyle::Flow);
+        PushFrame(Frame::CompactMap);
         return;
       }
       break;
@@ -129,74 +185,146 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   if (tag == "?")
     eventHandler.OnNull(mark, anchor);
   else
-    eventHandler.OnScalar(mark, tag, anchor, "");
+    eventHandler.OnScalarView(mark, tag, anchor, "");
 }
 
-void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_SEQ_START:
-      HandleBlockSequence(eventHandler);
+// PushFrame
+// . Opens a collection (eating its start token, if it has one).
+// . Throws a ParserException if that nests it deeper than m_maxDepth.
+void SingleDocParser::PushFrame(Frame::Kind kind) {
+  // the document's own frame doesn't count
+  if (m_maxDepth && kind != Frame::Document && m_frames.size() > m_maxDepth)
+    throw ParserException(m_scanner.peek().mark, ErrorMsg::NESTING_TOO_DEEP);
+
+  Frame frame;
+  frame.kind = kind;
+  frame.state = 0;
+
+  switch (kind) {
+    case Frame::Document:
       break;
-    case Token::FLOW_SEQ_START:
-      HandleFlowSequence(eventHandler);
+    case Frame::BlockSeq:
+      m_scanner.pop();
+      m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
       break;
-    default:
+    case Frame::FlowSeq:
+      m_scanner.pop();
+      m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
+      break;
+    case Frame::BlockMap:
+      m_scanner.pop();
+      m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
+      break;
+    case Frame::FlowMap:
+      m_scanner.pop();
+      m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
+      break;
+    case Frame::CompactMap:
+      m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
+      frame.mark = m_scanner.peek().mark;
+      m_scanner.pop();
+      break;
+    case Frame::CompactMapWithNoKey:
+      m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
       break;
   }
-}
 
-void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
-
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
+  m_frames.push_back(frame);
+}
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
+// PopFrame
+// . Closes the innermost collection and hands out its end event.
+template <typename Handler>
+void SingleDocParser::PopFrame(Handler& eventHandler) {
+  const Frame::Kind kind = m_frames.back().kind;
+  m_frames.pop_back();
 
-    m_scanner.pop();
-    if (token.type == Token::BLOCK_SEQ_END)
+  switch (kind) {
+    case Frame::Document:
+      eventHandler.OnDocumentEnd();
+      break;
+    case Frame::BlockSeq:
+      m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
+      eventHandler.OnSequenceEnd();
+      break;
+    case Frame::FlowSeq:
+      m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
+      eventHandler.OnSequenceEnd();
+      break;
+    case Frame::BlockMap:
+      m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
+      eventHandler.OnMapEnd();
+      break;
+    case Frame::FlowMap:
+      m_pCollectionStack->PopCollectionType(CollectionType::FlowMap);
+      eventHandler.OnMapEnd();
+      break;
+    case Frame::CompactMap:
+    case Frame::CompactMapWithNoKey:
+      m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+      eventHandler.OnMapEnd();
       break;
+  }
+}
 
-    // check for null
-    if (!m_scanner.empty()) {
-      const Token& token = m_scanner.peek();
-      if (token.type == Token::BLOCK_ENTRY ||
-          token.type == Token::BLOCK_SEQ_END) {
-        eventHandler.OnNull(token.mark, NullAnchor);
-        continue;
-      }
-    }
+template <typename Handler>
+bool SingleDocParser::StepDocument(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  switch (frame.state++) {
+    case 0:
+      eventHandler.OnDocumentStart(m_scanner.peek().mark);
+
+      // eat doc start
+      if (m_scanner.peek().type == Token::DOC_START)
+        m_scanner.pop();
+      return true;
+    case 1:
+      StartNode(eventHandler);
+      return true;
+    default:
+      PopFrame(eventHandler);
 
-    HandleNode(eventHandler);
+      // and finally eat any doc ends we see
+      while (!m_scanner.empty() && m_scanner.peek().type == Token::DOC_END)
+        m_scanner.pop();
+      return true;
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
 }
 
-void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
+template <typename Handler>
+bool SingleDocParser::StepBlockSequence(Handler& eventHandler) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
 
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+  Token token = m_scanner.peek();
+  if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
 
-    // first check for end
-    if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
-      m_scanner.pop();
-      break;
+  m_scanner.pop();
+  if (token.type == Token::BLOCK_SEQ_END) {
+    PopFrame(eventHandler);
+    return true;
+  }
+
+  // check for null
+  if (!m_scanner.empty()) {
+    const Token& token = m_scanner.peek();
+    if (token.type == Token::BLOCK_ENTRY ||
+        token.type == Token::BLOCK_SEQ_END) {
+      eventHandler.OnNull(token.mark, NullAnchor);
+      return true;
     }
+  }
 
-    // then read the node
-    HandleNode(eventHandler);
+  StartNode(eventHandler);
+  return true;
+}
 
+template <typename Handler>
+bool SingleDocParser::StepFlowSequence(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  if (frame.state == 1) {
+    frame.state = 0;
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
@@ -207,103 +335,83 @@ void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
       m_scanner.pop();
     else if (token.type != Token::FLOW_SEQ_END)
       throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
+    return false;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
-}
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
-void SingleDocParser::HandleMap(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_MAP_START:
-      HandleBlockMap(eventHandler);
-      break;
-    case Token::FLOW_MAP_START:
-      HandleFlowMap(eventHandler);
-      break;
-    case Token::KEY:
-      HandleCompactMap(eventHandler);
-      break;
-    case Token::VALUE:
-      HandleCompactMapWithNoKey(eventHandler);
-      break;
-    default:
-      break;
+  // first check for end
+  if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
+    m_scanner.pop();
+    PopFrame(eventHandler);
+    return true;
   }
-}
-
-void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
-
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
-
-    Token token = m_scanner.peek();
-    if (token.type != Token::KEY && token.type != Token::VALUE &&
-        token.type != Token::BLOCK_MAP_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
 
-    if (token.type == Token::BLOCK_MAP_END) {
-      m_scanner.pop();
-      break;
-    }
-
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
-    }
+  // then read the node
+  frame.state = 1;
+  StartNode(eventHandler);
+  return true;
+}
 
+template <typename Handler>
+bool SingleDocParser::StepBlockMap(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  if (frame.state == 1) {
     // now grab value (optional)
+    frame.state = 0;
     if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
       m_scanner.pop();
-      HandleNode(eventHandler);
+      StartNode(eventHandler);
     } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
+      eventHandler.OnNull(frame.mark, NullAnchor);
     }
+    return true;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
-}
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
 
-void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
+  Token token = m_scanner.peek();
+  if (token.type != Token::KEY && token.type != Token::VALUE &&
+      token.type != Token::BLOCK_MAP_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
 
-  while (1) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
-
-    Token& token = m_scanner.peek();
-    const Mark mark = token.mark;
-    // first check for end
-    if (token.type == Token::FLOW_MAP_END) {
-      m_scanner.pop();
-      break;
-    }
+  if (token.type == Token::BLOCK_MAP_END) {
+    m_scanner.pop();
+    PopFrame(eventHandler);
+    return true;
+  }
 
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
+  // grab key (if non-null)
+  frame.state = 1;
+  frame.mark = token.mark;
+  if (token.type == Token::KEY) {
+    m_scanner.pop();
+    StartNode(eventHandler);
+  } else {
+    eventHandler.OnNull(token.mark, NullAnchor);
+  }
+  return true;
+}
 
+template <typename Handler>
+bool SingleDocParser::StepFlowMap(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  if (frame.state == 1) {
     // now grab value (optional)
+    frame.state = 2;
     if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
       m_scanner.pop();
-      HandleNode(eventHandler);
+      StartNode(eventHandler);
     } else {
-      eventHandler.OnNull(mark, NullAnchor);
+      eventHandler.OnNull(frame.mark, NullAnchor);
     }
+    return true;
+  }
 
+  if (frame.state == 2) {
+    frame.state = 0;
     if (m_scanner.empty())
       throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
@@ -314,49 +422,82 @@ void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
       m_scanner.pop();
     else if (nextToken.type != Token::FLOW_MAP_END)
       throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
+    return false;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowMap);
-}
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
-// . Single "key: value" pair in a flow sequence
-void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // grab key
-  Mark mark = m_scanner.peek().mark;
-  m_scanner.pop();
-  HandleNode(eventHandler);
+  Token& token = m_scanner.peek();
+  const Mark mark = token.mark;
+  // first check for end
+  if (token.type == Token::FLOW_MAP_END) {
+    m_scanner.pop();
+    PopFrame(eventHandler);
+    return true;
+  }
 
-  // now grab value (optional)
-  if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+  // grab key (if non-null)
+  frame.state = 1;
+  frame.mark = mark;
+  if (token.type == Token::KEY) {
     m_scanner.pop();
-    HandleNode(eventHandler);
+    StartNode(eventHandler);
   } else {
     eventHandler.OnNull(mark, NullAnchor);
   }
+  return true;
+}
 
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+// . Single "key: value" pair in a flow sequence
+template <typename Handler>
+bool SingleDocParser::StepCompactMap(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  switch (frame.state++) {
+    case 0:
+      // grab key
+      StartNode(eventHandler);
+      return true;
+    case 1:
+      // now grab value (optional)
+      if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+        m_scanner.pop();
+        StartNode(eventHandler);
+      } else {
+        eventHandler.OnNull(frame.mark, NullAnchor);
+      }
+      return true;
+    default:
+      PopFrame(eventHandler);
+      return true;
+  }
 }
 
 // . Single ": value" pair in a flow sequence
-void SingleDocParser::HandleCompactMapWithNoKey(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // null key
-  eventHandler.OnNull(m_scanner.peek().mark, NullAnchor);
-
-  // grab value
-  m_scanner.pop();
-  HandleNode(eventHandler);
-
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+template <typename Handler>
+bool SingleDocParser::StepCompactMapWithNoKey(Handler& eventHandler) {
+  Frame& frame = m_frames.back();
+  switch (frame.state++) {
+    case 0:
+      // null key
+      eventHandler.OnNull(m_scanner.peek().mark, NullAnchor);
+      m_scanner.pop();
+      return true;
+    case 1:
+      // grab value
+      StartNode(eventHandler);
+      return true;
+    default:
+      PopFrame(eventHandler);
+      return true;
+  }
 }
 
 // ParseProperties
 // . Grabs any tag or anchor tokens and deals with them.
-void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor) {
-  tag.clear();
+void SingleDocParser::ParseProperties(const std::string*& pTag,
+                                      anchor_t& anchor) {
+  pTag = NULL;
   anchor = NullAnchor;
 
   while (1) {
@@ -365,7 +506,7 @@ void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor) {
 
     switch (m_scanner.peek().type) {
       case Token::TAG:
-        ParseTag(tag);
+        ParseTag(pTag);
         break;
       case Token::ANCHOR:
         ParseAnchor(anchor);
@@ -376,13 +517,31 @@ void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor) {
   }
 }
 
-void SingleDocParser::ParseTag(std::string& tag) {
+// ParseTag
+// . Points 'pTag' at the resolved tag, which stays valid (and the same for
+//   the same tag) for the whole document.
+void SingleDocParser::ParseTag(const std::string*& pTag) {
   Token& token = m_scanner.peek();
-  if (!tag.empty())
+  if (pTag)
     throw ParserException(token.mark, ErrorMsg::MULTIPLE_TAGS);
 
-  Tag tagInfo(token);
-  tag = tagInfo.Translate(m_directives);
+  // the directives don't change within a document, so each distinct tag
+  // is only translated once
+  m_tagKey.assign(1, static_cast<char>('0' + token.data));
+  m_tagKey += token.value;
+  if (!token.params.empty()) {
+    m_tagKey += '\0';
+    m_tagKey += token.params[0];
+  }
+
+  ResolvedTags::iterator it = m_resolvedTags.find(m_tagKey);
+  if (it == m_resolvedTags.end()) {
+    Tag tagInfo(token);
+    it = m_resolvedTags.insert(std::make_pair(m_tagKey,
+                                              tagInfo.Translate(m_directives)))
+             .first;
+  }
+  pTag = &it->second;
   m_scanner.pop();
 }
 
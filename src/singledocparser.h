@@ -7,44 +7,94 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "yaml-cpp/anchor.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/noncopyable.h"
 
 namespace YAML {
 class CollectionStack;
-class EventHandler;
+class ViewEventHandler;
 class Node;
+class NodeBuilder;
 class Scanner;
 struct Directives;
-struct Mark;
 struct Token;
 
 class SingleDocParser : private noncopyable {
  public:
-  SingleDocParser(Scanner& scanner, const Directives& directives);
+  // maxDepth limits how deep collections may nest; 0 means no limit
+  SingleDocParser(Scanner& scanner, const Directives& directives,
+                  std::size_t maxDepth = 0);
   ~SingleDocParser();
 
-  void HandleDocument(EventHandler& eventHandler);
+  bool HandleDocument(ViewEventHandler& eventHandler);
+  // the same, but with the calls to the builder bound statically
+  bool HandleDocument(NodeBuilder& builder);
+
+  // HandleNextEvent
+  // . Hands only the next event of the document to the handler. The parser
+  //   keeps its place in an explicit stack of open collections in between,
+  //   so nesting doesn't use up the call stack.
+  // . Returns false once the document is done.
+  bool HandleNextEvent(ViewEventHandler& eventHandler);
 
  private:
-  void HandleNode(EventHandler& eventHandler);
+  // a collection (or the document) whose events are under way
+  struct Frame {
+    enum Kind {
+      Document,
+      BlockSeq,
+      FlowSeq,
+      BlockMap,
+      FlowMap,
+      CompactMap,
+      CompactMapWithNoKey
+    };
+
+    Kind kind;
+    int state;  // where in the collection's loop we are
+    Mark mark;  // of the current key, for a null value
+  };
+
+  // The parsing itself is templated on the handler's type, and instantiated
+  // (in the .cpp) for ViewEventHandler and for NodeBuilder; the latter is
+  // final, so Load doesn't pay for a virtual call per event.
+  template <typename Handler>
+  bool HandleEvents(Handler& eventHandler);
+  template <typename Handler>
+  bool Step(Handler& eventHandler);
 
-  void HandleSequence(EventHandler& eventHandler);
-  void HandleBlockSequence(EventHandler& eventHandler);
-  void HandleFlowSequence(EventHandler& eventHandler);
+  template <typename Handler>
+  void StartNode(Handler& eventHandler);
+  void PushFrame(Frame::Kind kind);
+  template <typename Handler>
+  void PopFrame(Handler& eventHandler);
 
-  void HandleMap(EventHandler& eventHandler);
-  void HandleBlockMap(EventHandler& eventHandler);
-  void HandleFlowMap(EventHandler& eventHandler);
-  void HandleCompactMap(EventHandler& eventHandler);
-  void HandleCompactMapWithNoKey(EventHandler& eventHandler);
+  // each returns true if it handed an event to the handler
+  template <typename Handler>
+  bool StepDocument(Handler& eventHandler);
+  template <typename Handler>
+  bool StepBlockSequence(Handler& eventHandler);
+  template <typename Handler>
+  bool StepFlowSequence(Handler& eventHandler);
+  template <typename Handler>
+  bool StepBlockMap(Handler& eventHandler);
+  template <typename Handler>
+  bool StepFlowMap(Handler& eventHandler);
+  template <typename Handler>
+  bool StepCompactMap(Handler& eventHandler);
+  template <typename Handler>
+  bool StepCompactMapWithNoKey(Handler& eventHandler);
 
-  void ParseProperties(std::string& tag, anchor_t& anchor);
-  void ParseTag(std::string& tag);
+  void ParseProperties(const std::string*& pTag, anchor_t& anchor);
+  void ParseTag(const std::string*& pTag);
   void ParseAnchor(anchor_t& anchor);
 
   anchor_t RegisterAnchor(const std::string& name);
@@ -53,12 +103,21 @@ class SingleDocParser : private noncopyable {
  private:
   Scanner& m_scanner;
   const Directives& m_directives;
+  std::size_t m_maxDepth;
   std::unique_ptr<CollectionStack> m_pCollectionStack;
 
   typedef std::map<std::string, anchor_t> Anchors;
   Anchors m_anchors;
 
   anchor_t m_curAnchor;
+
+  // tags already translated, by token
+  typedef std::unordered_map<std::string, std::string> ResolvedTags;
+  ResolvedTags m_resolvedTags;
+  std::string m_tagKey;  // reused to look them up
+
+  std::vector<Frame> m_frames;
+  bool m_started;
 };
 }
 
@@ -5,6 +5,6 @@ TARGET = yaml-cpp
 QT -= gui
 QT -= core
 
-CONFIG += c++11
+CONFIG += c++11 thread
 
 include (src.pri)
@@ -191,8 +191,9 @@ inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
   }
 }
 
-Stream::Stream(std::istream& input, bool textEnabled)
+Stream::Stream(std::istream& input, bool textEnabled, const Mark& start)
     : m_input(input),
+      m_mark(start),
       m_bTextEnabled(textEnabled),
       m_pPrefetched(new unsigned char[YAML_PREFETCH_BUFF_SIZE]),
       m_nPrefetchedAvailable(0),
@@ -21,7 +21,8 @@ class Stream : private noncopyable {
  public:
   friend class StreamCharSource;
 
-  Stream(std::istream& input, bool textEnabled = false);
+  Stream(std::istream& input, bool textEnabled = false,
+         const Mark& start = Mark());
   ~Stream();
 
   operator bool() const;
@@ -0,0 +1,93 @@
+#include "textchunk.h"
+
+#include <istream>
+#include <iterator>
+
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/parser.h"
+#include "memorystreambuf.h"
+#include "nodebuilder.h"
+
+namespace YAML {
+std::string ReadAll(std::istream& input) {
+  return std::string(std::istreambuf_iterator<char>(input),
+                     std::istreambuf_iterator<char>());
+}
+
+bool CheckEncoding(const std::string& text, std::size_t& bom) {
+  bom = 0;
+  if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+    bom = 3;
+    return true;
+  }
+  if (text.compare(0, 2, "\xFE\xFF") == 0 ||
+      text.compare(0, 2, "\xFF\xFE") == 0)
+    return false;
+  for (std::size_t i = 0; i < 4 && i < text.size(); i++) {
+    if (text[i] == '\0')
+      return false;
+  }
+  return true;
+}
+
+bool IsBlankOrBreak(const std::string& text, std::size_t i) {
+  if (i >= text.size())
+    return true;
+  char ch = text[i];
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+bool IsDocIndicator(const std::string& text, std::size_t i, char ch) {
+  if (text.size() - i < 3 || text[i] != ch || text[i + 1] != ch ||
+      text[i + 2] != ch)
+    return false;
+  return IsBlankOrBreak(text, i + 3);
+}
+
+bool IsEmptyLine(const std::string& text, std::size_t i) {
+  while (i < text.size() && (text[i] == ' ' || text[i] == '\t'))
+    i++;
+  return i == text.size() || text[i] == '\n' || text[i] == '\r' ||
+         text[i] == '#';
+}
+
+std::size_t NextLine(const std::string& text, std::size_t i) {
+  std::size_t next = text.find('\n', i);
+  return next == std::string::npos ? text.size() : next + 1;
+}
+
+TextChunk MakeChunk(const std::string& text, std::size_t begin,
+                    std::size_t end, std::size_t bom, int line) {
+  std::size_t lineStart = bom;
+  if (begin > bom) {
+    std::size_t newline = text.rfind('\n', begin - 1);
+    if (newline != std::string::npos && newline >= bom)
+      lineStart = newline + 1;
+  }
+
+  TextChunk chunk;
+  chunk.begin = begin;
+  chunk.end = end;
+  chunk.mark.pos = static_cast<int>(begin - bom);
+  chunk.mark.line = line;
+  chunk.mark.column = static_cast<int>(begin - lineStart);
+  return chunk;
+}
+
+void ParseChunk(const std::string& text, const TextChunk& chunk,
+                bool textEnabled, bool internScalars, std::size_t maxDepth,
+                std::vector<Node>& docs) {
+  MemoryStreamBuf buffer(text.data() + chunk.begin, chunk.end - chunk.begin);
+  std::istream stream(&buffer);
+  Parser parser;
+  parser.Load(stream, textEnabled, chunk.mark);
+  parser.SetMaxDepth(maxDepth);
+  while (1) {
+    NodeBuilder builder(internScalars);
+    if (!builder.HandleNextDocument(parser))
+      break;
+    docs.push_back(builder.Root());
+  }
+}
+}
@@ -0,0 +1,64 @@
+#ifndef TEXTCHUNK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TEXTCHUNK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+class Node;
+
+// Helpers for the loaders that look at the raw text before (or instead of)
+// scanning it, and then parse pieces of it in place.
+
+// a piece of the input that is parsed on its own
+struct TextChunk {
+  std::size_t begin, end;
+  Mark mark;
+};
+
+std::string ReadAll(std::istream& input);
+
+// CheckEncoding
+// . Only UTF-8 text can be looked at as raw bytes; sets 'bom' to the size of
+//   the byte order mark, if any, since the scanner doesn't count it in marks.
+bool CheckEncoding(const std::string& text, std::size_t& bom);
+
+// true at a blank, a break or the end of the text
+bool IsBlankOrBreak(const std::string& text, std::size_t i);
+
+// IsDocIndicator
+// . Matches "---" or "..." (given by 'ch') followed by a blank, a break or
+//   the end of the text, like Exp::DocStart() and Exp::DocEnd().
+bool IsDocIndicator(const std::string& text, std::size_t i, char ch);
+
+// IsEmptyLine
+// . True if the rest of the line from i is only blanks and maybe a comment.
+bool IsEmptyLine(const std::string& text, std::size_t i);
+
+// NextLine
+// . Returns the start of the line after the one holding i.
+std::size_t NextLine(const std::string& text, std::size_t i);
+
+// MakeChunk
+// . A chunk starting at 'begin', which is on line 'line' of the text.
+TextChunk MakeChunk(const std::string& text, std::size_t begin,
+                    std::size_t end, std::size_t bom, int line);
+
+// ParseChunk
+// . Parses every document of the chunk, in place.
+void ParseChunk(const std::string& text, const TextChunk& chunk,
+                bool textEnabled, bool internScalars, std::size_t maxDepth,
+                std::vector<Node>& docs);
+}
+
+#endif  // TEXTCHUNK_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,63 @@
+#ifndef THREADPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define THREADPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace YAML {
+// ParallelFor
+// . Calls task(i) for every i in [0, count) on up to 'threads' threads (0
+//   means one per hardware thread); tasks are handed out in index order.
+// . If any task throws, the exception of the lowest failing index is rethrown
+//   once all threads have finished. No new tasks are started after a failure;
+//   since they are handed out in order, every lower index has already run.
+template <typename Task>
+void ParallelFor(std::size_t count, unsigned threads, Task task) {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  if (threads > count)
+    threads = static_cast<unsigned>(count);
+
+  std::vector<std::exception_ptr> errors(count);
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&]() {
+    while (!failed) {
+      std::size_t i = next++;
+      if (i >= count)
+        return;
+      try {
+        task(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned i = 1; i < threads; i++)
+    pool.push_back(std::thread(worker));
+  worker();
+  for (std::size_t i = 0; i < pool.size(); i++)
+    pool[i].join();
+
+  for (std::size_t i = 0; i < count; i++) {
+    if (errors[i])
+      std::rethrow_exception(errors[i]);
+  }
+}
+}
+
+#endif  // THREADPOOL_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -18,6 +18,364 @@ using ::testing::_;
 namespace YAML {
 namespace {
 
+// keeps every event it's handed, to compare with the ones pulled
+class EventCollector : public EventHandler {
+ public:
+  virtual void OnDocumentStart(const Mark& mark) {
+    Add(EventType::DocumentStart, mark);
+  }
+  virtual void OnDocumentEnd() { Add(EventType::DocumentEnd, Mark()); }
+  virtual void OnNull(const Mark& mark, anchor_t anchor) {
+    Add(EventType::Null, mark, "", anchor);
+  }
+  virtual void OnAlias(const Mark& mark, anchor_t anchor) {
+    Add(EventType::Alias, mark, "", anchor);
+  }
+  virtual void OnScalar(const Mark& mark, const std::string& tag,
+                        anchor_t anchor, const std::string& value) {
+    Add(EventType::Scalar, mark, tag, anchor, value);
+  }
+  virtual void OnSequenceStart(const Mark& mark, const std::string& tag,
+                               anchor_t anchor, EmitterStyle::value style) {
+    Add(EventType::SequenceStart, mark, tag, anchor, "", style);
+  }
+  virtual void OnSequenceEnd() { Add(EventType::SequenceEnd, Mark()); }
+  virtual void OnMapStart(const Mark& mark, const std::string& tag,
+                          anchor_t anchor, EmitterStyle::value style) {
+    Add(EventType::MapStart, mark, tag, anchor, "", style);
+  }
+  virtual void OnMapEnd() { Add(EventType::MapEnd, Mark()); }
+
+  std::vector<Event> events;
+
+ private:
+  void Add(EventType::value type, const Mark& mark, const std::string& tag = "",
+           anchor_t anchor = NullAnchor, const std::string& value = "",
+           EmitterStyle::value style = EmitterStyle::Default) {
+    Event event;
+    event.type = type;
+    event.mark = mark;
+    event.tag = tag;
+    event.anchor = anchor;
+    event.value = value;
+    event.style = style;
+    events.push_back(event);
+  }
+};
+
+void ExpectSameEvents(const std::vector<Event>& expected,
+                      const std::vector<Event>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].type, actual[i].type);
+    EXPECT_EQ(expected[i].mark.pos, actual[i].mark.pos);
+    EXPECT_EQ(expected[i].mark.line, actual[i].mark.line);
+    EXPECT_EQ(expected[i].mark.column, actual[i].mark.column);
+    EXPECT_EQ(expected[i].tag, actual[i].tag);
+    EXPECT_EQ(expected[i].anchor, actual[i].anchor);
+    EXPECT_EQ(expected[i].value, actual[i].value);
+    EXPECT_EQ(expected[i].style, actual[i].style);
+  }
+}
+
+TEST(NextEventTest, MatchesHandleNextDocument) {
+  const char* examples[] = {ex2_1,  ex2_2,  ex2_3,  ex2_4,  ex2_5,  ex2_6,
+                            ex2_7,  ex2_8,  ex2_9,  ex2_10, ex2_11, ex2_12,
+                            ex2_13, ex2_17, ex2_18, ex2_23, ex2_24, ex2_28,
+                            ex5_3,  ex6_29, ex7_15, ex7_21, ex8_20};
+  for (std::size_t i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+    EventCollector pushed;
+    std::stringstream pushStream(examples[i]);
+    Parser pushParser(pushStream);
+    while (pushParser.HandleNextDocument(pushed)) {
+    }
+
+    std::vector<Event> pulled;
+    std::stringstream pullStream(examples[i]);
+    Parser pullParser(pullStream);
+    Event event;
+    while (pullParser.NextEvent(event))
+      pulled.push_back(event);
+
+    ExpectSameEvents(pushed.events, pulled);
+  }
+}
+
+TEST(NextEventTest, StopAndFinishDocument) {
+  std::stringstream stream("- [a, b]\n- c\n--- d\n");
+  Parser parser(stream);
+  Event event;
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::DocumentStart, event.type);
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::SequenceStart, event.type);
+  EXPECT_EQ(EmitterStyle::Block, event.style);
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::SequenceStart, event.type);
+  EXPECT_EQ(EmitterStyle::Flow, event.style);
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::Scalar, event.type);
+  EXPECT_EQ("a", event.value);
+
+  // the rest of the first document goes to the handler
+  EventCollector rest;
+  ASSERT_TRUE(parser.HandleNextDocument(rest));
+  ASSERT_EQ(5, rest.events.size());
+  EXPECT_EQ("b", rest.events[0].value);
+  EXPECT_EQ(EventType::DocumentEnd, rest.events[4].type);
+
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::DocumentStart, event.type);
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ("d", event.value);
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_EQ(EventType::DocumentEnd, event.type);
+  EXPECT_FALSE(parser.NextEvent(event));
+}
+
+TEST(NextEventTest, ErrorDropsDocument) {
+  std::stringstream stream("- [a, b\n");
+  Parser parser(stream);
+  Event event;
+  ASSERT_TRUE(parser.NextEvent(event));
+  ASSERT_TRUE(parser.NextEvent(event));
+  EXPECT_TRUE(parser.InDocument());
+  try {
+    while (parser.NextEvent(event)) {
+    }
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException&) {
+  }
+  EXPECT_FALSE(parser.InDocument());
+
+  std::stringstream handled("- [a, b\n");
+  parser.Load(handled);
+  EventCollector collector;
+  EXPECT_THROW(parser.HandleNextDocument(collector), ParserException);
+  EXPECT_FALSE(parser.InDocument());
+}
+
+TEST(SingleDocParserTest, DeepNestingDoesNotRecurse) {
+  const int depth = 100000;
+  std::stringstream stream(std::string(depth, '[') + std::string(depth, ']'));
+  Parser parser(stream);
+  EventCollector collector;
+  ASSERT_TRUE(parser.HandleNextDocument(collector));
+  ASSERT_EQ(2 * depth + 2, collector.events.size());
+  EXPECT_EQ(EventType::SequenceStart, collector.events[depth].type);
+  EXPECT_EQ(EventType::SequenceEnd, collector.events[depth + 1].type);
+}
+
+TEST(SingleDocParserTest, MaxDepth) {
+  std::stringstream ok("a: [b, {c: d}]");
+  Parser parser(ok);
+  parser.SetMaxDepth(3);
+  EventCollector collector;
+  EXPECT_TRUE(parser.HandleNextDocument(collector));
+
+  std::stringstream deep("a: [b, {c: [d]}]");
+  parser.Load(deep);
+  parser.SetMaxDepth(3);
+  try {
+    parser.HandleNextDocument(collector);
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(ErrorMsg::NESTING_TOO_DEEP, e.msg);
+    EXPECT_EQ(11, e.mark.column);
+  }
+
+  Loader loader;
+  loader.m_maxDepth = 1;
+  EXPECT_THROW(loader.Load("[[a]]"), ParserException);
+  EXPECT_EQ(1, loader.Load("[a]").size());
+}
+
+// stops parsing after the scalar 'stopAt'
+class StoppingCollector : public EventCollector {
+ public:
+  explicit StoppingCollector(const std::string& stopAt) : m_stopAt(stopAt) {}
+
+  virtual void OnScalar(const Mark& mark, const std::string& tag,
+                        anchor_t anchor, const std::string& value) {
+    EventCollector::OnScalar(mark, tag, anchor, value);
+    if (value == m_stopAt)
+      StopParsing();
+  }
+
+ private:
+  std::string m_stopAt;
+};
+
+TEST(StopParsingTest, SkipDocument) {
+  std::stringstream stream(
+      "version: 2\nrecords: [a, b, c]\n--- {version: 3}\n");
+  Parser parser(stream);
+  StoppingCollector handler("2");
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_EQ(4, handler.events.size());
+  EXPECT_TRUE(parser.InDocument());
+
+  parser.SkipDocument();
+  EXPECT_FALSE(parser.InDocument());
+  handler.events.clear();
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  ASSERT_EQ(6, handler.events.size());
+  EXPECT_EQ("3", handler.events[3].value);
+  EXPECT_FALSE(parser.InDocument());
+  EXPECT_FALSE(parser.HandleNextDocument(handler));
+}
+
+TEST(StopParsingTest, Resume) {
+  const std::string input = "- a\n- [b, c]\n- d\n";
+  EventCollector all;
+  std::stringstream allStream(input);
+  Parser(allStream).HandleNextDocument(all);
+
+  std::stringstream stream(input);
+  Parser parser(stream);
+  StoppingCollector handler("b");
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_TRUE(parser.InDocument());
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_FALSE(parser.InDocument());
+  ExpectSameEvents(all.events, handler.events);
+
+  // stopping on the last event still finishes the document
+  struct StopAtEnd : public EventCollector {
+    virtual void OnDocumentEnd() {
+      EventCollector::OnDocumentEnd();
+      StopParsing();
+    }
+  } endHandler;
+  std::stringstream end("a\n--- b\n");
+  Parser endParser(end);
+  ASSERT_TRUE(endParser.HandleNextDocument(endHandler));
+  EXPECT_FALSE(endParser.InDocument());
+  ASSERT_TRUE(endParser.HandleNextDocument(endHandler));
+  EXPECT_EQ(6, endHandler.events.size());
+  EXPECT_FALSE(endParser.HandleNextDocument(endHandler));
+}
+
+// counts what it sees, without keeping any of it
+class CountingHandler : public ViewEventHandler {
+ public:
+  CountingHandler() : scalars(0), collections(0), bytes(0), strTags(0) {}
+
+  virtual void OnDocumentStart(const Mark&) {}
+  virtual void OnDocumentEnd() {}
+  virtual void OnNull(const Mark&, anchor_t) {}
+  virtual void OnAlias(const Mark&, anchor_t) {}
+  virtual void OnScalarView(const Mark&, const StringView& tag, anchor_t,
+                            const StringView& value) {
+    scalars++;
+    bytes += value.size();
+    if (tag == "tag:yaml.org,2002:str")
+      strTags++;
+  }
+  virtual void OnSequenceStartView(const Mark&, const StringView&, anchor_t,
+                                   EmitterStyle::value) {
+    collections++;
+  }
+  virtual void OnSequenceEnd() {}
+  virtual void OnMapStartView(const Mark&, const StringView&, anchor_t,
+                              EmitterStyle::value) {
+    collections++;
+  }
+  virtual void OnMapEnd() {}
+
+  int scalars, collections;
+  std::size_t bytes;
+  int strTags;
+};
+
+TEST(ViewEventHandlerTest, CountWithoutCopies) {
+  std::stringstream stream("- abc\n- !!str de\n- {k: v, !!str x: [y]}\n");
+  Parser parser(stream);
+  CountingHandler handler;
+  ASSERT_TRUE(parser.HandleNextDocument(handler));
+  EXPECT_EQ(6, handler.scalars);
+  EXPECT_EQ(3, handler.collections);
+  EXPECT_EQ(9u, handler.bytes);
+  EXPECT_EQ(2, handler.strTags);
+}
+
+TEST(ViewEventHandlerTest, StringView) {
+  const std::string str = "scalar";
+  std::string buffer;
+  EXPECT_EQ(&str, &StringView(str).str(buffer));
+  EXPECT_EQ("cal", StringView(str.data() + 1, 3).str(buffer));
+  EXPECT_EQ(StringView("cal"), StringView(str.data() + 1, 3));
+  EXPECT_NE(StringView("ca"), StringView(str.data() + 1, 3));
+  EXPECT_TRUE(StringView().empty());
+}
+
+TEST(EventTapeTest, ReplayMatchesParse) {
+  const char* examples[] = {ex2_3,  ex2_10, ex2_11, ex2_23,
+                            ex2_24, ex2_28, ex7_21, ex8_20};
+  for (std::size_t i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+    EventCollector parsed;
+    EventTape tape;
+    std::stringstream parsedStream(examples[i]), tapeStream(examples[i]);
+    Parser parsedParser(parsedStream), tapeParser(tapeStream);
+    while (parsedParser.HandleNextDocument(parsed)) {
+    }
+    while (tapeParser.HandleNextDocument(tape)) {
+    }
+    EXPECT_EQ(parsed.events.size(), tape.size());
+
+    for (int replay = 0; replay < 2; replay++) {
+      EventCollector replayed;
+      EXPECT_TRUE(tape.Replay(replayed));
+      ExpectSameEvents(parsed.events, replayed.events);
+    }
+  }
+}
+
+TEST(EventTapeTest, SaveAndRestore) {
+  std::stringstream stream(ex2_10);
+  Parser parser(stream);
+  EventTape tape;
+  while (parser.HandleNextDocument(tape)) {
+  }
+  std::stringstream saved;
+  tape.Save(saved);
+  const std::string data = saved.str();
+
+  EventTape restored;
+  ASSERT_TRUE(restored.Restore(data.data(), data.size()));
+  EventCollector expected, replayed;
+  tape.Replay(expected);
+  restored.Replay(replayed);
+  ExpectSameEvents(expected.events, replayed.events);
+
+  // and saves to the same bytes
+  std::stringstream resaved;
+  restored.Save(resaved);
+  EXPECT_EQ(data, resaved.str());
+
+  // a cut or damaged tape is refused
+  EXPECT_FALSE(restored.Restore(data.data(), data.size() - 1));
+  EXPECT_TRUE(restored.empty());
+  std::string damaged = data;
+  damaged[0] = 'X';
+  EXPECT_FALSE(restored.Restore(damaged.data(), damaged.size()));
+}
+
+TEST(EventTapeTest, StopReplay) {
+  std::stringstream stream("- a\n- b\n- c\n");
+  Parser parser(stream);
+  EventTape tape;
+  ASSERT_TRUE(parser.HandleNextDocument(tape));
+
+  StoppingCollector handler("b");
+  EXPECT_FALSE(tape.Replay(handler));
+  ASSERT_EQ(4, handler.events.size());
+  EXPECT_EQ("b", handler.events.back().value);
+
+  tape.clear();
+  EXPECT_TRUE(tape.empty());
+}
+
 TEST_F(HandlerTest, NoEndOfMapFlow) {
   EXPECT_THROW_PARSER_EXCEPTION(IgnoreParse("---{header: {id: 1"),
                                 ErrorMsg::END_OF_MAP_FLOW);
@@ -1,3 +1,8 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
 #include "gtest/gtest.h"
@@ -5,12 +10,12 @@
 namespace YAML {
 namespace {
 TEST(LoadNodeTest, Reassign) {
-  Node node = Load("foo");
+  Node node = Loader().Load("foo");
   node = Node();
 }
 
 TEST(LoadNodeTest, FallbackValues) {
-  Node node = Load("foo: bar\nx: 2");
+  Node node = Loader().Load("foo: bar\nx: 2");
   EXPECT_EQ("bar", node["foo"].as<std::string>());
   EXPECT_EQ("bar", node["foo"].as<std::string>("hello"));
   EXPECT_EQ("hello", node["baz"].as<std::string>("hello"));
@@ -20,7 +25,7 @@ TEST(LoadNodeTest, FallbackValues) {
 }
 
 TEST(LoadNodeTest, NumericConversion) {
-  Node node = Load("[1.5, 1, .nan, .inf, -.inf, 0x15, 015]");
+  Node node = Loader().Load("[1.5, 1, .nan, .inf, -.inf, 0x15, 015]");
   EXPECT_EQ(1.5f, node[0].as<float>());
   EXPECT_EQ(1.5, node[0].as<double>());
   EXPECT_THROW(node[0].as<int>(), TypedBadConversion<int>);
@@ -34,7 +39,7 @@ TEST(LoadNodeTest, NumericConversion) {
 }
 
 TEST(LoadNodeTest, Binary) {
-  Node node = Load(
+  Node node = Loader().Load(
       "[!!binary \"SGVsbG8sIFdvcmxkIQ==\", !!binary "
       "\"TWFuIGlzIGRpc3Rpbmd1aXNoZWQsIG5vdCBvbmx5IGJ5IGhpcyByZWFzb24sIGJ1dCBieS"
       "B0aGlzIHNpbmd1bGFyIHBhc3Npb24gZnJvbSBvdGhlciBhbmltYWxzLCB3aGljaCBpcyBhIG"
@@ -56,7 +61,7 @@ TEST(LoadNodeTest, Binary) {
 }
 
 TEST(LoadNodeTest, IterateSequence) {
-  Node node = Load("[1, 3, 5, 7]");
+  Node node = Loader().Load("[1, 3, 5, 7]");
   int seq[] = {1, 3, 5, 7};
   int i = 0;
   for (const_iterator it = node.begin(); it != node.end(); ++it) {
@@ -68,7 +73,7 @@ TEST(LoadNodeTest, IterateSequence) {
 }
 
 TEST(LoadNodeTest, IterateMap) {
-  Node node = Load("{a: A, b: B, c: C}");
+  Node node = Loader().Load("{a: A, b: B, c: C}");
   int i = 0;
   for (const_iterator it = node.begin(); it != node.end(); ++it) {
     EXPECT_TRUE(i < 3);
@@ -80,7 +85,7 @@ TEST(LoadNodeTest, IterateMap) {
 
 #ifdef BOOST_FOREACH
 TEST(LoadNodeTest, ForEach) {
-  Node node = Load("[1, 3, 5, 7]");
+  Node node = Loader().Load("[1, 3, 5, 7]");
   int seq[] = {1, 3, 5, 7};
   int i = 0;
   BOOST_FOREACH (const Node& item, node) {
@@ -90,7 +95,7 @@ TEST(LoadNodeTest, ForEach) {
 }
 
 TEST(LoadNodeTest, ForEachMap) {
-  Node node = Load("{a: A, b: B, c: C}");
+  Node node = Loader().Load("{a: A, b: B, c: C}");
   BOOST_FOREACH (const const_iterator::value_type& p, node) {
     EXPECT_EQ(p.second.as<char>(), p.first.as<char>() + 'A' - 'a');
   }
@@ -98,7 +103,7 @@ TEST(LoadNodeTest, ForEachMap) {
 #endif
 
 TEST(LoadNodeTest, CloneScalar) {
-  Node node = Load("!foo monkey");
+  Node node = Loader().Load("!foo monkey");
   Node clone = Clone(node);
   EXPECT_FALSE(clone == node);
   EXPECT_EQ(clone.as<std::string>(), node.as<std::string>());
@@ -106,7 +111,7 @@ TEST(LoadNodeTest, CloneScalar) {
 }
 
 TEST(LoadNodeTest, CloneSeq) {
-  Node node = Load("[1, 3, 5, 7]");
+  Node node = Loader().Load("[1, 3, 5, 7]");
   Node clone = Clone(node);
   EXPECT_FALSE(clone == node);
   EXPECT_EQ(NodeType::Sequence, clone.Type());
@@ -117,7 +122,7 @@ TEST(LoadNodeTest, CloneSeq) {
 }
 
 TEST(LoadNodeTest, CloneMap) {
-  Node node = Load("{foo: bar}");
+  Node node = Loader().Load("{foo: bar}");
   Node clone = Clone(node);
   EXPECT_FALSE(clone == node);
   EXPECT_EQ(NodeType::Map, clone.Type());
@@ -126,7 +131,7 @@ TEST(LoadNodeTest, CloneMap) {
 }
 
 TEST(LoadNodeTest, CloneAlias) {
-  Node node = Load("&foo [*foo]");
+  Node node = Loader().Load("&foo [*foo]");
   Node clone = Clone(node);
   EXPECT_FALSE(clone == node);
   EXPECT_EQ(NodeType::Sequence, clone.Type());
@@ -160,7 +165,7 @@ TEST(LoadNodeTest, ForceInsertIntoMap) {
 }
 
 TEST(LoadNodeTest, ResetNode) {
-  Node node = Load("[1, 2, 3]");
+  Node node = Loader().Load("[1, 2, 3]");
   EXPECT_TRUE(!node.IsNull());
   Node other = node;
   node.reset();
@@ -172,12 +177,12 @@ TEST(LoadNodeTest, ResetNode) {
 }
 
 TEST(LoadNodeTest, EmptyString) {
-  Node node = Load("\"\"");
+  Node node = Loader().Load("\"\"");
   EXPECT_TRUE(!node.IsNull());
 }
 
 TEST(LoadNodeTest, DereferenceIteratorError) {
-  Node node = Load("[{a: b}, 1, 2]");
+  Node node = Loader().Load("[{a: b}, 1, 2]");
   EXPECT_THROW(node.begin()->first.as<int>(), InvalidNode);
   EXPECT_EQ(true, (*node.begin()).IsMap());
   EXPECT_EQ(true, node.begin()->IsMap());
@@ -185,6 +190,330 @@ TEST(LoadNodeTest, DereferenceIteratorError) {
   EXPECT_THROW(node.begin()->begin()->Type(), InvalidNode);
 }
 
+TEST(LoadNodeTest, InternScalars) {
+  Loader loader;
+  loader.m_internScalars = true;
+  Node node = loader.Load("- {name: a, type: x}\n- {name: b, type: x}");
+  EXPECT_EQ("x", node[0]["type"].as<std::string>());
+  EXPECT_EQ(&node[0]["type"].Scalar(), &node[1]["type"].Scalar());
+  EXPECT_NE(&node[0]["name"].Scalar(), &node[1]["name"].Scalar());
+
+  node[0]["type"] = "y";
+  EXPECT_EQ("y", node[0]["type"].as<std::string>());
+  EXPECT_EQ("x", node[1]["type"].as<std::string>());
+}
+
+TEST(LoadNodeTest, InternedTags) {
+  Node node = Loader().Load(
+      "%TAG !e! tag:example.com,2000:\n---\n"
+      "- !!str a\n- !e!point b\n- !!str c\n- !e!point d\n- e\n- 'f'");
+  EXPECT_EQ("tag:yaml.org,2002:str", node[0].Tag());
+  EXPECT_EQ("tag:example.com,2000:point", node[1].Tag());
+  EXPECT_EQ(&node[0].Tag(), &node[2].Tag());
+  EXPECT_EQ(&node[1].Tag(), &node[3].Tag());
+  EXPECT_EQ("?", node[4].Tag());
+  EXPECT_EQ("!", node[5].Tag());
+
+  node[2].SetTag("!other");
+  EXPECT_EQ("!other", node[2].Tag());
+  EXPECT_EQ("tag:yaml.org,2002:str", node[0].Tag());
+
+  // a tag that resolves to nothing is non-specific too
+  node = Loader().Load("- !<> a\n- !<> 'b'");
+  EXPECT_EQ("?", node[0].Tag());
+  EXPECT_EQ("!", node[1].Tag());
+}
+
+TEST(LoadNodeTest, LoadAllParallel) {
+  const std::string input =
+      "a: 1\n"
+      "--- |\n"
+      "  text\n"
+      "---\n"
+      "- [x, y]\n"
+      "- z\n"
+      "...\n"
+      "b: {c: d}\n"
+      "--- last";
+  std::vector<Node> serial = Loader().LoadAll(input);
+  Loader loader;
+  loader.m_threads = 2;
+  std::vector<Node> docs = loader.LoadAllParallel(input);
+  ASSERT_EQ(5, docs.size());
+  ASSERT_EQ(serial.size(), docs.size());
+  for (std::size_t i = 0; i < docs.size(); i++) {
+    EXPECT_EQ(Dump(serial[i]), Dump(docs[i]));
+    EXPECT_EQ(serial[i].Mark().pos, docs[i].Mark().pos);
+    EXPECT_EQ(serial[i].Mark().line, docs[i].Mark().line);
+    EXPECT_EQ(serial[i].Mark().column, docs[i].Mark().column);
+  }
+  EXPECT_EQ(5, docs[2][1].Mark().line);
+  EXPECT_EQ(7, docs[3]["b"]["c"].Mark().line);
+}
+
+TEST(LoadNodeTest, LoadAllParallelError) {
+  Loader loader;
+  loader.m_threads = 2;
+  try {
+    loader.LoadAllParallel("a\n---\nb\n---\n[c\n---\nd\n");
+    FAIL() << "expected a ParserException";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(ErrorMsg::END_OF_SEQ_FLOW, e.msg);
+    EXPECT_EQ(5, e.mark.line);
+  }
+}
+
+TEST(LoadNodeTest, LoadParallelSequence) {
+  std::stringstream input;
+  input << "---\n";
+  for (int i = 0; i < 100; i++)
+    input << "- {id: " << i << "}\n";
+  Loader loader;
+  loader.m_threads = 4;
+  Node node = loader.LoadParallel(input.str());
+  ASSERT_TRUE(node.IsSequence());
+  ASSERT_EQ(100, node.size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, node[i]["id"].as<int>());
+    EXPECT_EQ(i + 1, node[i].Mark().line);
+  }
+}
+
+TEST(LoadNodeTest, LoadParallelMap) {
+  std::stringstream input;
+  for (int i = 0; i < 100; i++)
+    input << "key" << i << ":\n- " << i << "\n- x\n";
+  Loader loader;
+  loader.m_threads = 4;
+  Node node = loader.LoadParallel(input.str());
+  ASSERT_TRUE(node.IsMap());
+  ASSERT_EQ(100, node.size());
+  for (int i = 0; i < 100; i++) {
+    std::stringstream key;
+    key << "key" << i;
+    EXPECT_EQ(i, node[key.str()][0].as<int>());
+    EXPECT_EQ(3 * i + 1, node[key.str()].Mark().line);
+  }
+}
+
+TEST(LoadNodeTest, LoadParallelLargeMap) {
+  std::stringstream input;
+  for (int i = 0; i < 50000; i++)
+    input << "key" << i << ": {a: " << i << "}\n";
+  Loader loader;
+  loader.m_threads = 4;
+
+  typedef std::chrono::steady_clock clock;
+  clock::time_point start = clock::now();
+  Node serial = loader.Load(input.str());
+  clock::time_point split = clock::now();
+  Node node = loader.LoadParallel(input.str());
+  clock::time_point end = clock::now();
+
+  ASSERT_EQ(50000, node.size());
+  EXPECT_TRUE(Equals(serial, node));
+  const_iterator it = node.begin();
+  for (int i = 0; i < 50000; i++, ++it)
+    ASSERT_EQ("key" + std::to_string(i), it->first.Scalar());
+  EXPECT_EQ(49999, node["key49999"]["a"].as<int>());
+
+  // the chunks' entries are appended, not inserted one search at a time; a
+  // quadratic merge takes several times as long as the serial parse, even
+  // on a single thread
+  EXPECT_LT(end - split, 2 * (split - start) + std::chrono::milliseconds(500));
+}
+
+TEST(LoadNodeTest, LoadParallelAliasAcrossEntries) {
+  std::stringstream input;
+  input << "- &a {x: 1}\n";
+  for (int i = 0; i < 100; i++)
+    input << "- *a\n";
+  Loader loader;
+  loader.m_threads = 4;
+  Node node = loader.LoadParallel(input.str());
+  ASSERT_EQ(101, node.size());
+  EXPECT_TRUE(node[100].is(node[0]));
+}
+
+TEST(LoadNodeTest, LoadSelectedMap) {
+  const std::string input =
+      "global:\n"
+      "  region: eu\n"
+      "  zone: a\n"
+      "services:\n"
+      "  web:\n"
+      "    image: \"nginx\n"
+      "      latest\"\n"
+      "    port: 80\n"
+      "  db: {image: postgres,\n"
+      "   port: 5432}\n"
+      "  cache:\n"
+      "    port: 6379\n"
+      "debug:\n"
+      "  - a\n"
+      "  b: c\n";
+  Node node = Loader().LoadSelected(
+      input, std::vector<std::string>{"services.*.port", "global.region"});
+  ASSERT_TRUE(node.IsMap());
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ("eu", node["global"]["region"].as<std::string>());
+  EXPECT_FALSE(node["global"]["zone"]);
+  EXPECT_EQ(3, node["services"].size());
+  EXPECT_EQ(80, node["services"]["web"]["port"].as<int>());
+  EXPECT_EQ(7, node["services"]["web"]["port"].Mark().line);
+  EXPECT_EQ(10, node["services"]["web"]["port"].Mark().column);
+  EXPECT_FALSE(node["services"]["web"]["image"]);
+  EXPECT_EQ(5432, node["services"]["db"]["port"].as<int>());
+  EXPECT_EQ(6379, node["services"]["cache"]["port"].as<int>());
+  EXPECT_FALSE(node["debug"]);
+}
+
+TEST(LoadNodeTest, LoadSelectedSequence) {
+  const std::string input =
+      "---\n"
+      "- name: a\n"
+      "  tags: [x, 'y''s', \"]\"]\n"
+      "- name: b\n"
+      "  tags:\n"
+      "  - z\n"
+      "- |\n"
+      "  text\n"
+      "- name: c\n";
+  Node node = Loader().LoadSelected(
+      input, std::vector<std::string>{"*.name", "1.tags"});
+  ASSERT_TRUE(node.IsSequence());
+  ASSERT_EQ(3, node.size());
+  EXPECT_EQ("a", node[0]["name"].as<std::string>());
+  EXPECT_FALSE(node[0]["tags"]);
+  EXPECT_EQ("b", node[1]["name"].as<std::string>());
+  EXPECT_EQ("z", node[1]["tags"][0].as<std::string>());
+  EXPECT_EQ(5, node[1]["tags"].Mark().line);
+  EXPECT_EQ("c", node[2]["name"].as<std::string>());
+
+  EXPECT_TRUE(Loader().LoadSelected(input, std::vector<std::string>{"x"})
+                  .IsNull());
+}
+
+TEST(LoadNodeTest, LoadSelectedFallsBack) {
+  // the alias refers to an anchor that the walk skips, and the second path
+  // goes into a flow map; both need the whole document
+  const std::string input =
+      "base: &base {port: 80, host: h}\n"
+      "web: *base\n"
+      "db: {port: 5432, host: d}\n";
+  Node node = Loader().LoadSelected(
+      input, std::vector<std::string>{"web.port", "db.host"});
+  ASSERT_TRUE(node.IsMap());
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(80, node["web"]["port"].as<int>());
+  EXPECT_FALSE(node["web"]["host"]);
+  EXPECT_EQ("d", node["db"]["host"].as<std::string>());
+  EXPECT_FALSE(node["db"]["port"]);
+
+  Node flow = Loader().LoadSelected("{a: {b: 1, c: 2}}",
+                                    std::vector<std::string>{"a.c"});
+  EXPECT_EQ(1, flow["a"].size());
+  EXPECT_EQ(2, flow["a"]["c"].as<int>());
+}
+
+TEST(LoadNodeTest, NodesOutliveTheirDocument) {
+  Node node = Loader().Load("{a: [1, 2]}");
+  {
+    Node other = Loader().Load("{b: {c: 3}}");
+    node["a"].push_back(other["b"]);
+    node["d"] = other["b"]["c"];
+  }
+  EXPECT_EQ(3, node["a"][2]["c"].as<int>());
+  EXPECT_EQ(3, node["d"].as<int>());
+  node["d"] = 4;
+  EXPECT_EQ(4, node["a"][2]["c"].as<int>());
+}
+
+TEST(LoadNodeTest, LoadFileCache) {
+  const std::string filename = "load_file_cache_test.yaml";
+  const std::string cacheName = filename + ".cache";
+  std::ofstream(filename.c_str()) << "a: &x [1, !!str 2]\nb: *x\n";
+  std::remove(cacheName.c_str());
+
+  Loader loader;
+  loader.m_useCache = true;
+  Node parsed = loader.LoadFile(filename);
+  ASSERT_TRUE(std::ifstream(cacheName.c_str()).good());
+
+  Node cached = loader.LoadFile(filename);
+  ASSERT_TRUE(cached.IsMap());
+  EXPECT_EQ("2", cached["a"][1].as<std::string>());
+  EXPECT_EQ("tag:yaml.org,2002:str", cached["a"][1].Tag());
+  EXPECT_TRUE(cached["a"].is(cached["b"]));
+  EXPECT_EQ(parsed["a"][0].Mark().column, cached["a"][0].Mark().column);
+
+  // a changed file isn't served from the old cache
+  std::ofstream(filename.c_str()) << "a: [3]\n";
+  EXPECT_EQ(3, loader.LoadFile(filename)["a"][0].as<int>());
+
+  // nor is a damaged cache
+  std::ofstream(cacheName.c_str(), std::ios::app) << "junk";
+  EXPECT_EQ(3, loader.LoadFile(filename)["a"][0].as<int>());
+
+  // a cache written with no depth limit still obeys a later one
+  Loader limited;
+  limited.m_useCache = true;
+  limited.m_maxDepth = 1;
+  EXPECT_THROW(limited.LoadFile(filename), ParserException);
+
+  // with or without the cache, the file is read as it is
+  std::ofstream(filename.c_str(), std::ios::binary)
+      << "a: |\r\n  x\r\nb: y\r\n";
+  Loader uncached;
+  Node plain = uncached.LoadFile(filename);
+  loader.LoadFile(filename);
+  cached = loader.LoadFile(filename);
+  EXPECT_EQ(plain["a"].Scalar(), cached["a"].Scalar());
+  EXPECT_EQ(plain["b"].Mark().pos, cached["b"].Mark().pos);
+
+  std::remove(filename.c_str());
+  std::remove(cacheName.c_str());
+}
+
+TEST(LoadNodeTest, LoadFrozen) {
+  std::string input;
+  for (int i = 0; i < 20; i++)
+    input += "key" + std::to_string(i) + ": [" + std::to_string(i) + "]\n";
+
+  Loader loader;
+  loader.m_freeze = true;
+  Node node = loader.Load(input);
+  ASSERT_TRUE(node.IsFrozen());
+  EXPECT_TRUE(node["key3"].IsFrozen());
+
+  // changing a key elsewhere doesn't send the frozen map back to its index
+  Node other;
+  other["a"] = 1;
+  other.begin()->first = "b";
+
+  std::vector<std::thread> threads;
+  std::vector<int> sums(4);
+  for (std::size_t t = 0; t < sums.size(); t++) {
+    threads.push_back(std::thread([&node, &sums, t]() {
+      const Node& doc = node;
+      for (int i = 0; i < 20; i++)
+        sums[t] += doc["key" + std::to_string(i)][0].as<int>();
+    }));
+  }
+  for (std::size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  for (std::size_t t = 0; t < sums.size(); t++)
+    EXPECT_EQ(190, sums[t]);
+
+  EXPECT_FALSE(node["missing"].IsDefined());
+  EXPECT_EQ(20, node.size());
+  EXPECT_THROW(node["key0"] = 1, FrozenNode);
+  EXPECT_THROW(node["key0"].push_back(1), FrozenNode);
+  EXPECT_THROW(node.SetTag("!t"), FrozenNode);
+  EXPECT_THROW(node.remove("key0"), FrozenNode);
+  EXPECT_EQ(0, node["key0"][0].as<int>());
+}
+
 TEST(NodeTest, EmitEmptyNode) {
   Node node;
   Emitter emitter;
@@ -193,10 +522,10 @@ TEST(NodeTest, EmitEmptyNode) {
 }
 
 TEST(NodeTest, ParseNodeStyle) {
-  EXPECT_EQ(EmitterStyle::Flow, Load("[1, 2, 3]").Style());
-  EXPECT_EQ(EmitterStyle::Flow, Load("{foo: bar}").Style());
-  EXPECT_EQ(EmitterStyle::Block, Load("- foo\n- bar").Style());
-  EXPECT_EQ(EmitterStyle::Block, Load("foo: bar").Style());
+  EXPECT_EQ(EmitterStyle::Flow, Loader().Load("[1, 2, 3]").Style());
+  EXPECT_EQ(EmitterStyle::Flow, Loader().Load("{foo: bar}").Style());
+  EXPECT_EQ(EmitterStyle::Block, Loader().Load("- foo\n- bar").Style());
+  EXPECT_EQ(EmitterStyle::Block, Loader().Load("foo: bar").Style());
 }
 }
 }
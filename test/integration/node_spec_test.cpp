@@ -15,7 +15,7 @@ namespace YAML {
 namespace {
 
 TEST(NodeSpecTest, Ex2_1_SeqScalars) {
-  Node doc = Load(ex2_1);
+  Node doc = Loader().Load(ex2_1);
   EXPECT_TRUE(doc.IsSequence());
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("Mark McGwire", doc[0].as<std::string>());
@@ -24,7 +24,7 @@ TEST(NodeSpecTest, Ex2_1_SeqScalars) {
 }
 
 TEST(NodeSpecTest, Ex2_2_MappingScalarsToScalars) {
-  Node doc = Load(ex2_2);
+  Node doc = Loader().Load(ex2_2);
   EXPECT_TRUE(doc.IsMap());
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("65", doc["hr"].as<std::string>());
@@ -33,7 +33,7 @@ TEST(NodeSpecTest, Ex2_2_MappingScalarsToScalars) {
 }
 
 TEST(NodeSpecTest, Ex2_3_MappingScalarsToSequences) {
-  Node doc = Load(ex2_3);
+  Node doc = Loader().Load(ex2_3);
   EXPECT_TRUE(doc.IsMap());
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(3, doc["american"].size());
@@ -47,7 +47,7 @@ TEST(NodeSpecTest, Ex2_3_MappingScalarsToSequences) {
 }
 
 TEST(NodeSpecTest, Ex2_4_SequenceOfMappings) {
-  Node doc = Load(ex2_4);
+  Node doc = Loader().Load(ex2_4);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(3, doc[0].size());
   EXPECT_EQ("Mark McGwire", doc[0]["name"].as<std::string>());
@@ -60,7 +60,7 @@ TEST(NodeSpecTest, Ex2_4_SequenceOfMappings) {
 }
 
 TEST(NodeSpecTest, Ex2_5_SequenceOfSequences) {
-  Node doc = Load(ex2_5);
+  Node doc = Loader().Load(ex2_5);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ(3, doc[0].size());
   EXPECT_EQ("name", doc[0][0].as<std::string>());
@@ -77,7 +77,7 @@ TEST(NodeSpecTest, Ex2_5_SequenceOfSequences) {
 }
 
 TEST(NodeSpecTest, Ex2_6_MappingOfMappings) {
-  Node doc = Load(ex2_6);
+  Node doc = Loader().Load(ex2_6);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["Mark McGwire"].size());
   EXPECT_EQ("65", doc["Mark McGwire"]["hr"].as<std::string>());
@@ -88,7 +88,7 @@ TEST(NodeSpecTest, Ex2_6_MappingOfMappings) {
 }
 
 TEST(NodeSpecTest, Ex2_7_TwoDocumentsInAStream) {
-  std::vector<Node> docs = LoadAll(ex2_7);
+  std::vector<Node> docs = Loader().LoadAll(ex2_7);
   EXPECT_EQ(2, docs.size());
 
   {
@@ -108,7 +108,7 @@ TEST(NodeSpecTest, Ex2_7_TwoDocumentsInAStream) {
 }
 
 TEST(NodeSpecTest, Ex2_8_PlayByPlayFeed) {
-  std::vector<Node> docs = LoadAll(ex2_8);
+  std::vector<Node> docs = Loader().LoadAll(ex2_8);
   EXPECT_EQ(2, docs.size());
 
   {
@@ -129,7 +129,7 @@ TEST(NodeSpecTest, Ex2_8_PlayByPlayFeed) {
 }
 
 TEST(NodeSpecTest, Ex2_9_SingleDocumentWithTwoComments) {
-  Node doc = Load(ex2_9);
+  Node doc = Loader().Load(ex2_9);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["hr"].size());
   EXPECT_EQ("Mark McGwire", doc["hr"][0].as<std::string>());
@@ -140,7 +140,7 @@ TEST(NodeSpecTest, Ex2_9_SingleDocumentWithTwoComments) {
 }
 
 TEST(NodeSpecTest, Ex2_10_SimpleAnchor) {
-  Node doc = Load(ex2_10);
+  Node doc = Loader().Load(ex2_10);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["hr"].size());
   EXPECT_EQ("Mark McGwire", doc["hr"][0].as<std::string>());
@@ -151,7 +151,7 @@ TEST(NodeSpecTest, Ex2_10_SimpleAnchor) {
 }
 
 TEST(NodeSpecTest, Ex2_11_MappingBetweenSequences) {
-  Node doc = Load(ex2_11);
+  Node doc = Loader().Load(ex2_11);
 
   std::vector<std::string> tigers_cubs;
   tigers_cubs.push_back("Detroit Tigers");
@@ -171,7 +171,7 @@ TEST(NodeSpecTest, Ex2_11_MappingBetweenSequences) {
 }
 
 TEST(NodeSpecTest, Ex2_12_CompactNestedMapping) {
-  Node doc = Load(ex2_12);
+  Node doc = Loader().Load(ex2_12);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ(2, doc[0].size());
   EXPECT_EQ("Super Hoop", doc[0]["item"].as<std::string>());
@@ -185,21 +185,21 @@ TEST(NodeSpecTest, Ex2_12_CompactNestedMapping) {
 }
 
 TEST(NodeSpecTest, Ex2_13_InLiteralsNewlinesArePreserved) {
-  Node doc = Load(ex2_13);
+  Node doc = Loader().Load(ex2_13);
   EXPECT_TRUE(doc.as<std::string>() ==
               "\\//||\\/||\n"
               "// ||  ||__");
 }
 
 TEST(NodeSpecTest, Ex2_14_InFoldedScalarsNewlinesBecomeSpaces) {
-  Node doc = Load(ex2_14);
+  Node doc = Loader().Load(ex2_14);
   EXPECT_TRUE(doc.as<std::string>() ==
               "Mark McGwire's year was crippled by a knee injury.");
 }
 
 TEST(NodeSpecTest,
      Ex2_15_FoldedNewlinesArePreservedForMoreIndentedAndBlankLines) {
-  Node doc = Load(ex2_15);
+  Node doc = Loader().Load(ex2_15);
   EXPECT_TRUE(doc.as<std::string>() ==
               "Sammy Sosa completed another fine season with great stats.\n\n"
               "  63 Home Runs\n"
@@ -208,7 +208,7 @@ TEST(NodeSpecTest,
 }
 
 TEST(NodeSpecTest, Ex2_16_IndentationDeterminesScope) {
-  Node doc = Load(ex2_16);
+  Node doc = Loader().Load(ex2_16);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("Mark McGwire", doc["name"].as<std::string>());
   EXPECT_TRUE(doc["accomplishment"].as<std::string>() ==
@@ -218,7 +218,7 @@ TEST(NodeSpecTest, Ex2_16_IndentationDeterminesScope) {
 }
 
 TEST(NodeSpecTest, Ex2_17_QuotedScalars) {
-  Node doc = Load(ex2_17);
+  Node doc = Loader().Load(ex2_17);
   EXPECT_EQ(6, doc.size());
   EXPECT_EQ("Sosa did fine.\xe2\x98\xba", doc["unicode"].as<std::string>());
   EXPECT_EQ("\b1998\t1999\t2000\n", doc["control"].as<std::string>());
@@ -229,7 +229,7 @@ TEST(NodeSpecTest, Ex2_17_QuotedScalars) {
 }
 
 TEST(NodeSpecTest, Ex2_18_MultiLineFlowScalars) {
-  Node doc = Load(ex2_18);
+  Node doc = Loader().Load(ex2_18);
   EXPECT_EQ(2, doc.size());
   EXPECT_TRUE(doc["plain"].as<std::string>() ==
               "This unquoted scalar spans many lines.");
@@ -240,7 +240,7 @@ TEST(NodeSpecTest, Ex2_18_MultiLineFlowScalars) {
 // TODO: 2.19 - 2.22 schema tags
 
 TEST(NodeSpecTest, Ex2_23_VariousExplicitTags) {
-  Node doc = Load(ex2_23);
+  Node doc = Loader().Load(ex2_23);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("tag:yaml.org,2002:str", doc["not-date"].Tag());
   EXPECT_EQ("2002-04-28", doc["not-date"].as<std::string>());
@@ -258,7 +258,7 @@ TEST(NodeSpecTest, Ex2_23_VariousExplicitTags) {
 }
 
 TEST(NodeSpecTest, Ex2_24_GlobalTags) {
-  Node doc = Load(ex2_24);
+  Node doc = Loader().Load(ex2_24);
   EXPECT_EQ("tag:clarkevans.com,2002:shape", doc.Tag());
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("tag:clarkevans.com,2002:circle", doc[0].Tag());
@@ -285,7 +285,7 @@ TEST(NodeSpecTest, Ex2_24_GlobalTags) {
 }
 
 TEST(NodeSpecTest, Ex2_25_UnorderedSets) {
-  Node doc = Load(ex2_25);
+  Node doc = Loader().Load(ex2_25);
   EXPECT_EQ("tag:yaml.org,2002:set", doc.Tag());
   EXPECT_EQ(3, doc.size());
   EXPECT_TRUE(doc["Mark McGwire"].IsNull());
@@ -294,7 +294,7 @@ TEST(NodeSpecTest, Ex2_25_UnorderedSets) {
 }
 
 TEST(NodeSpecTest, Ex2_16_OrderedMappings) {
-  Node doc = Load(ex2_26);
+  Node doc = Loader().Load(ex2_26);
   EXPECT_EQ("tag:yaml.org,2002:omap", doc.Tag());
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ(1, doc[0].size());
@@ -306,7 +306,7 @@ TEST(NodeSpecTest, Ex2_16_OrderedMappings) {
 }
 
 TEST(NodeSpecTest, Ex2_27_Invoice) {
-  Node doc = Load(ex2_27);
+  Node doc = Loader().Load(ex2_27);
   EXPECT_EQ("tag:clarkevans.com,2002:invoice", doc.Tag());
   EXPECT_EQ(8, doc.size());
   EXPECT_EQ(34843, doc["invoice"].as<int>());
@@ -352,7 +352,7 @@ TEST(NodeSpecTest, Ex2_27_Invoice) {
 }
 
 TEST(NodeSpecTest, Ex2_28_LogFile) {
-  std::vector<Node> docs = LoadAll(ex2_28);
+  std::vector<Node> docs = Loader().LoadAll(ex2_28);
   EXPECT_EQ(3, docs.size());
 
   {
@@ -395,7 +395,7 @@ TEST(NodeSpecTest, Ex2_28_LogFile) {
 // TODO: 5.1 - 5.2 BOM
 
 TEST(NodeSpecTest, Ex5_3_BlockStructureIndicators) {
-  Node doc = Load(ex5_3);
+  Node doc = Loader().Load(ex5_3);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["sequence"].size());
   EXPECT_EQ("one", doc["sequence"][0].as<std::string>());
@@ -406,7 +406,7 @@ TEST(NodeSpecTest, Ex5_3_BlockStructureIndicators) {
 }
 
 TEST(NodeSpecTest, Ex5_4_FlowStructureIndicators) {
-  Node doc = Load(ex5_4);
+  Node doc = Loader().Load(ex5_4);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["sequence"].size());
   EXPECT_EQ("one", doc["sequence"][0].as<std::string>());
@@ -417,12 +417,12 @@ TEST(NodeSpecTest, Ex5_4_FlowStructureIndicators) {
 }
 
 TEST(NodeSpecTest, Ex5_5_CommentIndicator) {
-  Node doc = Load(ex5_5);
+  Node doc = Loader().Load(ex5_5);
   EXPECT_TRUE(doc.IsNull());
 }
 
 TEST(NodeSpecTest, Ex5_6_NodePropertyIndicators) {
-  Node doc = Load(ex5_6);
+  Node doc = Loader().Load(ex5_6);
   EXPECT_EQ(2, doc.size());
   EXPECT_TRUE(doc["anchored"].as<std::string>() ==
               "value");  // TODO: assert tag
@@ -430,14 +430,14 @@ TEST(NodeSpecTest, Ex5_6_NodePropertyIndicators) {
 }
 
 TEST(NodeSpecTest, Ex5_7_BlockScalarIndicators) {
-  Node doc = Load(ex5_7);
+  Node doc = Loader().Load(ex5_7);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ("some\ntext\n", doc["literal"].as<std::string>());
   EXPECT_EQ("some text\n", doc["folded"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex5_8_QuotedScalarIndicators) {
-  Node doc = Load(ex5_8);
+  Node doc = Loader().Load(ex5_8);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ("text", doc["single"].as<std::string>());
   EXPECT_EQ("text", doc["double"].as<std::string>());
@@ -447,13 +447,13 @@ TEST(NodeSpecTest, Ex5_8_QuotedScalarIndicators) {
 // TODO: 5.10 reserved indicator
 
 TEST(NodeSpecTest, Ex5_11_LineBreakCharacters) {
-  Node doc = Load(ex5_11);
+  Node doc = Loader().Load(ex5_11);
   EXPECT_TRUE(doc.as<std::string>() ==
               "Line break (no glyph)\nLine break (glyphed)\n");
 }
 
 TEST(NodeSpecTest, Ex5_12_TabsAndSpaces) {
-  Node doc = Load(ex5_12);
+  Node doc = Loader().Load(ex5_12);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ("Quoted\t", doc["quoted"].as<std::string>());
   EXPECT_TRUE(doc["block"].as<std::string>() ==
@@ -463,7 +463,7 @@ TEST(NodeSpecTest, Ex5_12_TabsAndSpaces) {
 }
 
 TEST(NodeSpecTest, Ex5_13_EscapedCharacters) {
-  Node doc = Load(ex5_13);
+  Node doc = Loader().Load(ex5_13);
   EXPECT_TRUE(doc.as<std::string>() ==
               "Fun with \x5C \x22 \x07 \x08 \x1B \x0C \x0A \x0D \x09 \x0B " +
                   std::string("\x00", 1) +
@@ -471,12 +471,12 @@ TEST(NodeSpecTest, Ex5_13_EscapedCharacters) {
 }
 
 TEST(NodeSpecTest, Ex5_14_InvalidEscapedCharacters) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex5_14),
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex5_14),
                                 std::string(ErrorMsg::INVALID_ESCAPE) + "c");
 }
 
 TEST(NodeSpecTest, Ex6_1_IndentationSpaces) {
-  Node doc = Load(ex6_1);
+  Node doc = Loader().Load(ex6_1);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(2, doc["Not indented"].size());
   EXPECT_TRUE(doc["Not indented"]["By one space"].as<std::string>() ==
@@ -491,7 +491,7 @@ TEST(NodeSpecTest, Ex6_1_IndentationSpaces) {
 }
 
 TEST(NodeSpecTest, Ex6_2_IndentationIndicators) {
-  Node doc = Load(ex6_2);
+  Node doc = Loader().Load(ex6_2);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(2, doc["a"].size());
   EXPECT_EQ("b", doc["a"][0].as<std::string>());
@@ -501,7 +501,7 @@ TEST(NodeSpecTest, Ex6_2_IndentationIndicators) {
 }
 
 TEST(NodeSpecTest, Ex6_3_SeparationSpaces) {
-  Node doc = Load(ex6_3);
+  Node doc = Loader().Load(ex6_3);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(1, doc[0].size());
   EXPECT_EQ("bar", doc[0]["foo"].as<std::string>());
@@ -511,7 +511,7 @@ TEST(NodeSpecTest, Ex6_3_SeparationSpaces) {
 }
 
 TEST(NodeSpecTest, Ex6_4_LinePrefixes) {
-  Node doc = Load(ex6_4);
+  Node doc = Loader().Load(ex6_4);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("text lines", doc["plain"].as<std::string>());
   EXPECT_EQ("text lines", doc["quoted"].as<std::string>());
@@ -519,46 +519,46 @@ TEST(NodeSpecTest, Ex6_4_LinePrefixes) {
 }
 
 TEST(NodeSpecTest, Ex6_5_EmptyLines) {
-  Node doc = Load(ex6_5);
+  Node doc = Loader().Load(ex6_5);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ("Empty line\nas a line feed", doc["Folding"].as<std::string>());
   EXPECT_EQ("Clipped empty lines\n", doc["Chomping"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_6_LineFolding) {
-  Node doc = Load(ex6_6);
+  Node doc = Loader().Load(ex6_6);
   EXPECT_EQ("trimmed\n\n\nas space", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_7_BlockFolding) {
-  Node doc = Load(ex6_7);
+  Node doc = Loader().Load(ex6_7);
   EXPECT_EQ("foo \n\n\t bar\n\nbaz\n", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_8_FlowFolding) {
-  Node doc = Load(ex6_8);
+  Node doc = Loader().Load(ex6_8);
   EXPECT_EQ(" foo\nbar\nbaz ", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_9_SeparatedComment) {
-  Node doc = Load(ex6_9);
+  Node doc = Loader().Load(ex6_9);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ("value", doc["key"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_10_CommentLines) {
-  Node doc = Load(ex6_10);
+  Node doc = Loader().Load(ex6_10);
   EXPECT_TRUE(doc.IsNull());
 }
 
 TEST(NodeSpecTest, Ex6_11_MultiLineComments) {
-  Node doc = Load(ex6_11);
+  Node doc = Loader().Load(ex6_11);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ("value", doc["key"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_12_SeparationSpacesII) {
-  Node doc = Load(ex6_12);
+  Node doc = Loader().Load(ex6_12);
 
   std::map<std::string, std::string> sammy;
   sammy["first"] = "Sammy";
@@ -571,32 +571,32 @@ TEST(NodeSpecTest, Ex6_12_SeparationSpacesII) {
 }
 
 TEST(NodeSpecTest, Ex6_13_ReservedDirectives) {
-  Node doc = Load(ex6_13);
+  Node doc = Loader().Load(ex6_13);
   EXPECT_EQ("foo", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_14_YAMLDirective) {
-  Node doc = Load(ex6_14);
+  Node doc = Loader().Load(ex6_14);
   EXPECT_EQ("foo", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_15_InvalidRepeatedYAMLDirective) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex6_15),
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex6_15),
                                 ErrorMsg::REPEATED_YAML_DIRECTIVE);
 }
 
 TEST(NodeSpecTest, Ex6_16_TagDirective) {
-  Node doc = Load(ex6_16);
+  Node doc = Loader().Load(ex6_16);
   EXPECT_EQ("tag:yaml.org,2002:str", doc.Tag());
   EXPECT_EQ("foo", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_17_InvalidRepeatedTagDirective) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex6_17), ErrorMsg::REPEATED_TAG_DIRECTIVE);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex6_17), ErrorMsg::REPEATED_TAG_DIRECTIVE);
 }
 
 TEST(NodeSpecTest, Ex6_18_PrimaryTagHandle) {
-  std::vector<Node> docs = LoadAll(ex6_18);
+  std::vector<Node> docs = Loader().LoadAll(ex6_18);
   EXPECT_EQ(2, docs.size());
 
   {
@@ -613,19 +613,19 @@ TEST(NodeSpecTest, Ex6_18_PrimaryTagHandle) {
 }
 
 TEST(NodeSpecTest, Ex6_19_SecondaryTagHandle) {
-  Node doc = Load(ex6_19);
+  Node doc = Loader().Load(ex6_19);
   EXPECT_EQ("tag:example.com,2000:app/int", doc.Tag());
   EXPECT_EQ("1 - 3", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_20_TagHandles) {
-  Node doc = Load(ex6_20);
+  Node doc = Loader().Load(ex6_20);
   EXPECT_EQ("tag:example.com,2000:app/foo", doc.Tag());
   EXPECT_EQ("bar", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_21_LocalTagPrefix) {
-  std::vector<Node> docs = LoadAll(ex6_21);
+  std::vector<Node> docs = Loader().LoadAll(ex6_21);
   EXPECT_EQ(2, docs.size());
 
   {
@@ -642,14 +642,14 @@ TEST(NodeSpecTest, Ex6_21_LocalTagPrefix) {
 }
 
 TEST(NodeSpecTest, Ex6_22_GlobalTagPrefix) {
-  Node doc = Load(ex6_22);
+  Node doc = Loader().Load(ex6_22);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ("tag:example.com,2000:app/foo", doc[0].Tag());
   EXPECT_EQ("bar", doc[0].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex6_23_NodeProperties) {
-  Node doc = Load(ex6_23);
+  Node doc = Loader().Load(ex6_23);
   EXPECT_EQ(2, doc.size());
   for (const_iterator it = doc.begin(); it != doc.end(); ++it) {
     if (it->first.as<std::string>() == "foo") {
@@ -664,7 +664,7 @@ TEST(NodeSpecTest, Ex6_23_NodeProperties) {
 }
 
 TEST(NodeSpecTest, Ex6_24_VerbatimTags) {
-  Node doc = Load(ex6_24);
+  Node doc = Loader().Load(ex6_24);
   EXPECT_EQ(1, doc.size());
   for (const_iterator it = doc.begin(); it != doc.end(); ++it) {
     EXPECT_EQ("tag:yaml.org,2002:str", it->first.Tag());
@@ -675,13 +675,13 @@ TEST(NodeSpecTest, Ex6_24_VerbatimTags) {
 }
 
 TEST(NodeSpecTest, DISABLED_Ex6_25_InvalidVerbatimTags) {
-  Node doc = Load(ex6_25);
+  Node doc = Loader().Load(ex6_25);
   // TODO: check tags (but we probably will say these are valid, I think)
   FAIL() << "not implemented yet";
 }
 
 TEST(NodeSpecTest, Ex6_26_TagShorthands) {
-  Node doc = Load(ex6_26);
+  Node doc = Loader().Load(ex6_26);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("!local", doc[0].Tag());
   EXPECT_EQ("foo", doc[0].as<std::string>());
@@ -692,17 +692,17 @@ TEST(NodeSpecTest, Ex6_26_TagShorthands) {
 }
 
 TEST(NodeSpecTest, Ex6_27a_InvalidTagShorthands) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex6_27a), ErrorMsg::TAG_WITH_NO_SUFFIX);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex6_27a), ErrorMsg::TAG_WITH_NO_SUFFIX);
 }
 
 // TODO: should we reject this one (since !h! is not declared)?
 TEST(NodeSpecTest, DISABLED_Ex6_27b_InvalidTagShorthands) {
-  Load(ex6_27b);
+  Loader().Load(ex6_27b);
   FAIL() << "not implemented yet";
 }
 
 TEST(NodeSpecTest, Ex6_28_NonSpecificTags) {
-  Node doc = Load(ex6_28);
+  Node doc = Loader().Load(ex6_28);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("12", doc[0].as<std::string>());  // TODO: check tags. How?
   EXPECT_EQ(12, doc[1].as<int>());
@@ -710,14 +710,14 @@ TEST(NodeSpecTest, Ex6_28_NonSpecificTags) {
 }
 
 TEST(NodeSpecTest, Ex6_29_NodeAnchors) {
-  Node doc = Load(ex6_29);
+  Node doc = Loader().Load(ex6_29);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ("Value", doc["First occurrence"].as<std::string>());
   EXPECT_EQ("Value", doc["Second occurrence"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex7_1_AliasNodes) {
-  Node doc = Load(ex7_1);
+  Node doc = Loader().Load(ex7_1);
   EXPECT_EQ(4, doc.size());
   EXPECT_EQ("Foo", doc["First occurrence"].as<std::string>());
   EXPECT_EQ("Foo", doc["Second occurrence"].as<std::string>());
@@ -726,7 +726,7 @@ TEST(NodeSpecTest, Ex7_1_AliasNodes) {
 }
 
 TEST(NodeSpecTest, Ex7_2_EmptyNodes) {
-  Node doc = Load(ex7_2);
+  Node doc = Loader().Load(ex7_2);
   EXPECT_EQ(2, doc.size());
   for (const_iterator it = doc.begin(); it != doc.end(); ++it) {
     if (it->first.as<std::string>() == "foo") {
@@ -741,14 +741,14 @@ TEST(NodeSpecTest, Ex7_2_EmptyNodes) {
 }
 
 TEST(NodeSpecTest, Ex7_3_CompletelyEmptyNodes) {
-  Node doc = Load(ex7_3);
+  Node doc = Loader().Load(ex7_3);
   EXPECT_EQ(2, doc.size());
   EXPECT_TRUE(doc["foo"].IsNull());
   EXPECT_EQ("bar", doc[Null].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex7_4_DoubleQuotedImplicitKeys) {
-  Node doc = Load(ex7_4);
+  Node doc = Loader().Load(ex7_4);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc["implicit block key"].size());
   EXPECT_EQ(1, doc["implicit block key"][0].size());
@@ -758,24 +758,24 @@ TEST(NodeSpecTest, Ex7_4_DoubleQuotedImplicitKeys) {
 }
 
 TEST(NodeSpecTest, Ex7_5_DoubleQuotedLineBreaks) {
-  Node doc = Load(ex7_5);
+  Node doc = Loader().Load(ex7_5);
   EXPECT_TRUE(doc.as<std::string>() ==
               "folded to a space,\nto a line feed, or \t \tnon-content");
 }
 
 TEST(NodeSpecTest, Ex7_6_DoubleQuotedLines) {
-  Node doc = Load(ex7_6);
+  Node doc = Loader().Load(ex7_6);
   EXPECT_TRUE(doc.as<std::string>() ==
               " 1st non-empty\n2nd non-empty 3rd non-empty ");
 }
 
 TEST(NodeSpecTest, Ex7_7_SingleQuotedCharacters) {
-  Node doc = Load(ex7_7);
+  Node doc = Loader().Load(ex7_7);
   EXPECT_EQ("here's to \"quotes\"", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex7_8_SingleQuotedImplicitKeys) {
-  Node doc = Load(ex7_8);
+  Node doc = Loader().Load(ex7_8);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc["implicit block key"].size());
   EXPECT_EQ(1, doc["implicit block key"][0].size());
@@ -785,13 +785,13 @@ TEST(NodeSpecTest, Ex7_8_SingleQuotedImplicitKeys) {
 }
 
 TEST(NodeSpecTest, Ex7_9_SingleQuotedLines) {
-  Node doc = Load(ex7_9);
+  Node doc = Loader().Load(ex7_9);
   EXPECT_TRUE(doc.as<std::string>() ==
               " 1st non-empty\n2nd non-empty 3rd non-empty ");
 }
 
 TEST(NodeSpecTest, Ex7_10_PlainCharacters) {
-  Node doc = Load(ex7_10);
+  Node doc = Loader().Load(ex7_10);
   EXPECT_EQ(6, doc.size());
   EXPECT_EQ("::vector", doc[0].as<std::string>());
   EXPECT_EQ(": - ()", doc[1].as<std::string>());
@@ -807,7 +807,7 @@ TEST(NodeSpecTest, Ex7_10_PlainCharacters) {
 }
 
 TEST(NodeSpecTest, Ex7_11_PlainImplicitKeys) {
-  Node doc = Load(ex7_11);
+  Node doc = Loader().Load(ex7_11);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc["implicit block key"].size());
   EXPECT_EQ(1, doc["implicit block key"][0].size());
@@ -817,13 +817,13 @@ TEST(NodeSpecTest, Ex7_11_PlainImplicitKeys) {
 }
 
 TEST(NodeSpecTest, Ex7_12_PlainLines) {
-  Node doc = Load(ex7_12);
+  Node doc = Loader().Load(ex7_12);
   EXPECT_TRUE(doc.as<std::string>() ==
               "1st non-empty\n2nd non-empty 3rd non-empty");
 }
 
 TEST(NodeSpecTest, Ex7_13_FlowSequence) {
-  Node doc = Load(ex7_13);
+  Node doc = Loader().Load(ex7_13);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc[0].size());
   EXPECT_EQ("one", doc[0][0].as<std::string>());
@@ -834,7 +834,7 @@ TEST(NodeSpecTest, Ex7_13_FlowSequence) {
 }
 
 TEST(NodeSpecTest, Ex7_14_FlowSequenceEntries) {
-  Node doc = Load(ex7_14);
+  Node doc = Loader().Load(ex7_14);
   EXPECT_EQ(5, doc.size());
   EXPECT_EQ("double quoted", doc[0].as<std::string>());
   EXPECT_EQ("single quoted", doc[1].as<std::string>());
@@ -846,7 +846,7 @@ TEST(NodeSpecTest, Ex7_14_FlowSequenceEntries) {
 }
 
 TEST(NodeSpecTest, Ex7_15_FlowMappings) {
-  Node doc = Load(ex7_15);
+  Node doc = Loader().Load(ex7_15);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc[0].size());
   EXPECT_EQ("two", doc[0]["one"].as<std::string>());
@@ -857,7 +857,7 @@ TEST(NodeSpecTest, Ex7_15_FlowMappings) {
 }
 
 TEST(NodeSpecTest, Ex7_16_FlowMappingEntries) {
-  Node doc = Load(ex7_16);
+  Node doc = Loader().Load(ex7_16);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("entry", doc["explicit"].as<std::string>());
   EXPECT_EQ("entry", doc["implicit"].as<std::string>());
@@ -865,7 +865,7 @@ TEST(NodeSpecTest, Ex7_16_FlowMappingEntries) {
 }
 
 TEST(NodeSpecTest, Ex7_17_FlowMappingSeparateValues) {
-  Node doc = Load(ex7_17);
+  Node doc = Loader().Load(ex7_17);
   EXPECT_EQ(4, doc.size());
   EXPECT_EQ("separate", doc["unquoted"].as<std::string>());
   EXPECT_TRUE(doc["http://foo.com"].IsNull());
@@ -874,7 +874,7 @@ TEST(NodeSpecTest, Ex7_17_FlowMappingSeparateValues) {
 }
 
 TEST(NodeSpecTest, Ex7_18_FlowMappingAdjacentValues) {
-  Node doc = Load(ex7_18);
+  Node doc = Loader().Load(ex7_18);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("value", doc["adjacent"].as<std::string>());
   EXPECT_EQ("value", doc["readable"].as<std::string>());
@@ -882,21 +882,21 @@ TEST(NodeSpecTest, Ex7_18_FlowMappingAdjacentValues) {
 }
 
 TEST(NodeSpecTest, Ex7_19_SinglePairFlowMappings) {
-  Node doc = Load(ex7_19);
+  Node doc = Loader().Load(ex7_19);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc[0].size());
   EXPECT_EQ("bar", doc[0]["foo"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex7_20_SinglePairExplicitEntry) {
-  Node doc = Load(ex7_20);
+  Node doc = Loader().Load(ex7_20);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc[0].size());
   EXPECT_EQ("baz", doc[0]["foo bar"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex7_21_SinglePairImplicitEntries) {
-  Node doc = Load(ex7_21);
+  Node doc = Loader().Load(ex7_21);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ(1, doc[0].size());
   EXPECT_EQ(1, doc[0][0].size());
@@ -913,11 +913,11 @@ TEST(NodeSpecTest, Ex7_21_SinglePairImplicitEntries) {
 }
 
 TEST(NodeSpecTest, Ex7_22_InvalidImplicitKeys) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex7_22), ErrorMsg::END_OF_SEQ_FLOW);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex7_22), ErrorMsg::END_OF_SEQ_FLOW);
 }
 
 TEST(NodeSpecTest, Ex7_23_FlowContent) {
-  Node doc = Load(ex7_23);
+  Node doc = Loader().Load(ex7_23);
   EXPECT_EQ(5, doc.size());
   EXPECT_EQ(2, doc[0].size());
   EXPECT_EQ("a", doc[0][0].as<std::string>());
@@ -930,7 +930,7 @@ TEST(NodeSpecTest, Ex7_23_FlowContent) {
 }
 
 TEST(NodeSpecTest, Ex7_24_FlowNodes) {
-  Node doc = Load(ex7_24);
+  Node doc = Loader().Load(ex7_24);
   EXPECT_EQ(5, doc.size());
   EXPECT_EQ("tag:yaml.org,2002:str", doc[0].Tag());
   EXPECT_EQ("a", doc[0].as<std::string>());
@@ -942,7 +942,7 @@ TEST(NodeSpecTest, Ex7_24_FlowNodes) {
 }
 
 TEST(NodeSpecTest, Ex8_1_BlockScalarHeader) {
-  Node doc = Load(ex8_1);
+  Node doc = Loader().Load(ex8_1);
   EXPECT_EQ(4, doc.size());
   EXPECT_EQ("literal\n", doc[0].as<std::string>());
   EXPECT_EQ(" folded\n", doc[1].as<std::string>());
@@ -951,7 +951,7 @@ TEST(NodeSpecTest, Ex8_1_BlockScalarHeader) {
 }
 
 TEST(NodeSpecTest, Ex8_2_BlockIndentationHeader) {
-  Node doc = Load(ex8_2);
+  Node doc = Loader().Load(ex8_2);
   EXPECT_EQ(4, doc.size());
   EXPECT_EQ("detected\n", doc[0].as<std::string>());
   EXPECT_EQ("\n\n# detected\n", doc[1].as<std::string>());
@@ -960,19 +960,19 @@ TEST(NodeSpecTest, Ex8_2_BlockIndentationHeader) {
 }
 
 TEST(NodeSpecTest, Ex8_3a_InvalidBlockScalarIndentationIndicators) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex8_3a), ErrorMsg::END_OF_SEQ);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex8_3a), ErrorMsg::END_OF_SEQ);
 }
 
 TEST(NodeSpecTest, Ex8_3b_InvalidBlockScalarIndentationIndicators) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex8_3b), ErrorMsg::END_OF_SEQ);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex8_3b), ErrorMsg::END_OF_SEQ);
 }
 
 TEST(NodeSpecTest, Ex8_3c_InvalidBlockScalarIndentationIndicators) {
-  EXPECT_THROW_PARSER_EXCEPTION(Load(ex8_3c), ErrorMsg::END_OF_SEQ);
+  EXPECT_THROW_PARSER_EXCEPTION(Loader().Load(ex8_3c), ErrorMsg::END_OF_SEQ);
 }
 
 TEST(NodeSpecTest, Ex8_4_ChompingFinalLineBreak) {
-  Node doc = Load(ex8_4);
+  Node doc = Loader().Load(ex8_4);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("text", doc["strip"].as<std::string>());
   EXPECT_EQ("text\n", doc["clip"].as<std::string>());
@@ -980,7 +980,7 @@ TEST(NodeSpecTest, Ex8_4_ChompingFinalLineBreak) {
 }
 
 TEST(NodeSpecTest, DISABLED_Ex8_5_ChompingTrailingLines) {
-  Node doc = Load(ex8_5);
+  Node doc = Loader().Load(ex8_5);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("# text", doc["strip"].as<std::string>());
   EXPECT_EQ("# text\n", doc["clip"].as<std::string>());
@@ -990,7 +990,7 @@ TEST(NodeSpecTest, DISABLED_Ex8_5_ChompingTrailingLines) {
 }
 
 TEST(NodeSpecTest, Ex8_6_EmptyScalarChomping) {
-  Node doc = Load(ex8_6);
+  Node doc = Loader().Load(ex8_6);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("", doc["strip"].as<std::string>());
   EXPECT_EQ("", doc["clip"].as<std::string>());
@@ -998,50 +998,50 @@ TEST(NodeSpecTest, Ex8_6_EmptyScalarChomping) {
 }
 
 TEST(NodeSpecTest, Ex8_7_LiteralScalar) {
-  Node doc = Load(ex8_7);
+  Node doc = Loader().Load(ex8_7);
   EXPECT_EQ("literal\n\ttext\n", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex8_8_LiteralContent) {
-  Node doc = Load(ex8_8);
+  Node doc = Loader().Load(ex8_8);
   EXPECT_EQ("\n\nliteral\n \n\ntext\n", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex8_9_FoldedScalar) {
-  Node doc = Load(ex8_9);
+  Node doc = Loader().Load(ex8_9);
   EXPECT_EQ("folded text\n", doc.as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex8_10_FoldedLines) {
-  Node doc = Load(ex8_10);
+  Node doc = Loader().Load(ex8_10);
   EXPECT_TRUE(doc.as<std::string>() ==
               "\nfolded line\nnext line\n  * bullet\n\n  * list\n  * "
               "lines\n\nlast line\n");
 }
 
 TEST(NodeSpecTest, Ex8_11_MoreIndentedLines) {
-  Node doc = Load(ex8_11);
+  Node doc = Loader().Load(ex8_11);
   EXPECT_TRUE(doc.as<std::string>() ==
               "\nfolded line\nnext line\n  * bullet\n\n  * list\n  * "
               "lines\n\nlast line\n");
 }
 
 TEST(NodeSpecTest, Ex8_12_EmptySeparationLines) {
-  Node doc = Load(ex8_12);
+  Node doc = Loader().Load(ex8_12);
   EXPECT_TRUE(doc.as<std::string>() ==
               "\nfolded line\nnext line\n  * bullet\n\n  * list\n  * "
               "lines\n\nlast line\n");
 }
 
 TEST(NodeSpecTest, Ex8_13_FinalEmptyLines) {
-  Node doc = Load(ex8_13);
+  Node doc = Loader().Load(ex8_13);
   EXPECT_TRUE(doc.as<std::string>() ==
               "\nfolded line\nnext line\n  * bullet\n\n  * list\n  * "
               "lines\n\nlast line\n");
 }
 
 TEST(NodeSpecTest, Ex8_14_BlockSequence) {
-  Node doc = Load(ex8_14);
+  Node doc = Loader().Load(ex8_14);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(2, doc["block sequence"].size());
   EXPECT_EQ("one", doc["block sequence"][0].as<std::string>());
@@ -1050,7 +1050,7 @@ TEST(NodeSpecTest, Ex8_14_BlockSequence) {
 }
 
 TEST(NodeSpecTest, Ex8_15_BlockSequenceEntryTypes) {
-  Node doc = Load(ex8_15);
+  Node doc = Loader().Load(ex8_15);
   EXPECT_EQ(4, doc.size());
   EXPECT_TRUE(doc[0].IsNull());
   EXPECT_EQ("block node\n", doc[1].as<std::string>());
@@ -1062,14 +1062,14 @@ TEST(NodeSpecTest, Ex8_15_BlockSequenceEntryTypes) {
 }
 
 TEST(NodeSpecTest, Ex8_16_BlockMappings) {
-  Node doc = Load(ex8_16);
+  Node doc = Loader().Load(ex8_16);
   EXPECT_EQ(1, doc.size());
   EXPECT_EQ(1, doc["block mapping"].size());
   EXPECT_EQ("value", doc["block mapping"]["key"].as<std::string>());
 }
 
 TEST(NodeSpecTest, Ex8_17_ExplicitBlockMappingEntries) {
-  Node doc = Load(ex8_17);
+  Node doc = Loader().Load(ex8_17);
   EXPECT_EQ(2, doc.size());
   EXPECT_TRUE(doc["explicit key"].IsNull());
   EXPECT_EQ(2, doc["block key\n"].size());
@@ -1078,7 +1078,7 @@ TEST(NodeSpecTest, Ex8_17_ExplicitBlockMappingEntries) {
 }
 
 TEST(NodeSpecTest, Ex8_18_ImplicitBlockMappingEntries) {
-  Node doc = Load(ex8_18);
+  Node doc = Loader().Load(ex8_18);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("in-line value", doc["plain key"].as<std::string>());
   EXPECT_TRUE(doc[Null].IsNull());
@@ -1087,7 +1087,7 @@ TEST(NodeSpecTest, Ex8_18_ImplicitBlockMappingEntries) {
 }
 
 TEST(NodeSpecTest, Ex8_19_CompactBlockMappings) {
-  Node doc = Load(ex8_19);
+  Node doc = Loader().Load(ex8_19);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(1, doc[0].size());
   EXPECT_EQ("yellow", doc[0]["sun"].as<std::string>());
@@ -1099,7 +1099,7 @@ TEST(NodeSpecTest, Ex8_19_CompactBlockMappings) {
 }
 
 TEST(NodeSpecTest, Ex8_20_BlockNodeTypes) {
-  Node doc = Load(ex8_20);
+  Node doc = Loader().Load(ex8_20);
   EXPECT_EQ(3, doc.size());
   EXPECT_EQ("flow in block", doc[0].as<std::string>());
   EXPECT_EQ("Block scalar\n", doc[1].as<std::string>());
@@ -1108,7 +1108,7 @@ TEST(NodeSpecTest, Ex8_20_BlockNodeTypes) {
 }
 
 TEST(NodeSpecTest, DISABLED_Ex8_21_BlockScalarNodes) {
-  Node doc = Load(ex8_21);
+  Node doc = Loader().Load(ex8_21);
   EXPECT_EQ(2, doc.size());
   // NOTE: I believe this is a bug in the YAML spec -
   // it should be "value\n"
@@ -1118,7 +1118,7 @@ TEST(NodeSpecTest, DISABLED_Ex8_21_BlockScalarNodes) {
 }
 
 TEST(NodeSpecTest, Ex8_22_BlockCollectionNodes) {
-  Node doc = Load(ex8_22);
+  Node doc = Loader().Load(ex8_22);
   EXPECT_EQ(2, doc.size());
   EXPECT_EQ(2, doc["sequence"].size());
   EXPECT_EQ("entry", doc["sequence"][0].as<std::string>());
@@ -4,6 +4,9 @@
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/convert.h"
 #include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/view.h"
+#include "yaml-cpp/node/compare.h"
+#include "yaml-cpp/node/parse.h"
 #include "yaml-cpp/node/detail/impl.h"
 
 #include "gmock/gmock.h"
@@ -315,6 +318,396 @@ TEST(NodeTest, KeyNodeExitsScope) {
   }
 }
 
+TEST(NodeTest, MergedMemoryOutlivesOwners) {
+  Node inner;
+  inner["list"].push_back(1);
+  Node kept = inner["list"];  // shares inner's memory
+  Node outer;
+  {
+    Node middle;
+    middle.push_back(inner);
+    outer.push_back(middle);
+    inner = Node();
+  }
+  kept.push_back(2);  // a node made through the merged-away memory
+  outer.push_back(kept);
+  outer = Node();
+  EXPECT_EQ(2, kept.size());
+  EXPECT_EQ(2, kept[1].as<int>());
+}
+
+TEST(NodeTest, BuildLargeSequence) {
+  Node node;
+  for (int i = 0; i < 100000; i++)
+    node.push_back(i);
+  ASSERT_EQ(100000, node.size());
+  EXPECT_EQ(99999, node[99999].as<int>());
+}
+
+TEST(NodeTest, LargeMapLookup) {
+  Node node;
+  for (int i = 0; i < 10000; i++)
+    node["key" + std::to_string(i)] = i;
+  ASSERT_EQ(10000, node.size());
+  EXPECT_EQ(1234, node["key1234"].as<int>());
+  EXPECT_FALSE(const_cast<const Node&>(node)["missing"]);
+
+  EXPECT_TRUE(node.remove("key1234"));
+  EXPECT_FALSE(node.remove("key1234"));
+  EXPECT_EQ(9999, node.size());
+  node["key1234"] = "back";
+  EXPECT_EQ("back", node["key1234"].as<std::string>());
+  EXPECT_EQ(10000, node.size());
+
+  // removing from the middle keeps the other entries' order and lookups
+  for (int i = 0; i < 10000; i += 2) {
+    ASSERT_TRUE(node.remove("key" + std::to_string(i)));
+    ASSERT_EQ(i + 1, node["key" + std::to_string(i + 1)].as<int>());
+  }
+  EXPECT_EQ(5000, node.size());
+  EXPECT_FALSE(const_cast<const Node&>(node)["key1234"]);
+  const_iterator it = node.begin();
+  EXPECT_EQ("key1", (it++)->first.as<std::string>());
+  EXPECT_EQ("key3", (it++)->first.as<std::string>());
+  EXPECT_EQ("key5", it->first.as<std::string>());
+  node["key0"] = 0;
+  EXPECT_EQ(5001, node.size());
+  EXPECT_EQ(0, node["key0"].as<int>());
+  EXPECT_EQ(9999, node["key9999"].as<int>());
+}
+
+TEST(NodeTest, LargeMapKeyChanges) {
+  Node node;
+  Node key("old");
+  for (int i = 0; i < 20; i++)
+    node[std::to_string(i)] = i;
+  node[key] = "value";
+  EXPECT_EQ("value", node["old"].as<std::string>());
+
+  // the key node is shared, so changing it changes the map's key
+  key = "new";
+  EXPECT_EQ("value", node["new"].as<std::string>());
+  EXPECT_FALSE(const_cast<const Node&>(node)["old"]);
+
+  // a key of two maps changes both, also when another node replaces it
+  Node other;
+  for (int i = 0; i < 20; i++)
+    other[std::to_string(i)] = -i;
+  other[key] = "other";
+  key = Node("newer");
+  EXPECT_EQ("value", node["newer"].as<std::string>());
+  EXPECT_EQ("other", other["newer"].as<std::string>());
+  EXPECT_FALSE(const_cast<const Node&>(node)["new"]);
+  EXPECT_FALSE(const_cast<const Node&>(other)["new"]);
+
+  // with two keys of the same text, removing one finds the other
+  node.force_insert("5", "again");
+  EXPECT_TRUE(node.remove("5"));
+  EXPECT_TRUE(node.remove("5"));
+  EXPECT_FALSE(node.remove("5"));
+}
+
+TEST(NodeTest, MapKeepsInsertionOrder) {
+  Node node;
+  const char* keys[] = {"zeta", "alpha", "mu", "beta"};
+  for (int i = 0; i < 4; i++)
+    node[keys[i]] = i;
+  Node key("omega");
+  node.force_insert(key, 4);
+  node.force_insert(key, 5);  // the same key node keeps its place
+
+  ASSERT_EQ(5, node.size());
+  int i = 0;
+  for (const_iterator it = node.begin(); it != node.end(); ++it, ++i) {
+    if (i < 4) {
+      EXPECT_EQ(keys[i], it->first.as<std::string>());
+    }
+  }
+  EXPECT_EQ(5, node["omega"].as<int>());
+
+  node.remove("alpha");
+  std::stringstream out;
+  out << node;
+  EXPECT_EQ("zeta: 0\nmu: 2\nbeta: 3\nomega: 5", out.str());
+}
+
+TEST(NodeTest, SizeCountsDefinedElements) {
+  Node seq;
+  seq[0];
+  seq[1];
+  EXPECT_EQ(0, seq.size());
+  seq[1] = "b";
+  EXPECT_EQ(0, seq.size());
+  seq[0] = "a";
+  EXPECT_EQ(2, seq.size());
+
+  Node map;
+  map["a"];
+  map["b"] = "x";
+  EXPECT_EQ(1, map.size());
+  map.remove("a");
+  EXPECT_EQ(1, map.size());
+  map["a"] = "y";
+  EXPECT_EQ(2, map.size());
+}
+
+TEST(NodeTest, ChangeTypeKeepsTag) {
+  Node node;
+  node.SetTag("!t");
+  node[0] = "a";
+  EXPECT_TRUE(node.IsSequence());
+  EXPECT_EQ(1, node.size());
+  node["key"] = "b";
+  EXPECT_TRUE(node.IsMap());
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ("a", node["0"].as<std::string>());
+  node = "text";
+  EXPECT_EQ("text", node.Scalar());
+  EXPECT_EQ("!t", node.Tag());
+  node.SetTag("!u");
+  EXPECT_EQ("!u", node.Tag());
+}
+
+TEST(NodeTest, NestedLookupsDefineParents) {
+  Node node;
+  for (int i = 0; i < 3; i++)
+    node["a"]["b"]["c"];
+  EXPECT_EQ(0, node.size());
+
+  node["a"]["b"]["c"] = 1;
+  EXPECT_EQ(1, node.size());
+  EXPECT_EQ(1, node["a"].size());
+  EXPECT_EQ(1, node["a"]["b"]["c"].as<int>());
+}
+
+TEST(NodeTest, NodeView) {
+  Node node;
+  node["a"]["b"] = 3;
+  node["list"].push_back(1);
+  node["list"].push_back(2);
+  node["list"].SetTag("!l");
+
+  NodeView view(node);
+  EXPECT_TRUE(view.IsMap());
+  EXPECT_EQ(2, view.size());
+  EXPECT_EQ(3, view["a"]["b"].as<int>());
+  EXPECT_TRUE(view["a"].is(NodeView(node["a"])));
+  EXPECT_EQ("!l", view["list"].Tag());
+  EXPECT_EQ(2, view["list"][1].as<int>());
+  std::vector<int> list = view["list"].as<std::vector<int> >();
+  EXPECT_EQ(2, list.size());
+
+  int sum = 0;
+  for (NodeView::const_iterator it = view["list"].begin();
+       it != view["list"].end(); ++it)
+    sum += it->as<int>();
+  EXPECT_EQ(3, sum);
+  std::vector<std::string> keys;
+  for (NodeView::const_iterator it = view.begin(); it != view.end(); ++it)
+    keys.push_back(it->first.Scalar());
+  EXPECT_EQ((std::vector<std::string>{"a", "list"}), keys);
+
+  NodeView missing = view["x"]["y"];
+  EXPECT_FALSE(missing);
+  EXPECT_EQ(NodeType::Undefined, missing.Type());
+  EXPECT_EQ(7, missing.as<int>(7));
+  EXPECT_THROW(missing.as<int>(), InvalidNode);
+
+  // looking through a view adds nothing: a placeholder for "x" would have
+  // kept its place ahead of "z"
+  node["z"] = 1;
+  node["x"] = 2;
+  keys.clear();
+  for (const_iterator it = node.begin(); it != node.end(); ++it)
+    keys.push_back(it->first.Scalar());
+  EXPECT_EQ((std::vector<std::string>{"a", "list", "z", "x"}), keys);
+}
+
+TEST(NodeTest, CollectGarbage) {
+  Node node;
+  for (int i = 0; i < 50; i++) {
+    Node list;
+    list.push_back(i);
+    list.push_back(i + 1);
+    node["list"] = list;
+    node["tmp"]["x"] = i;
+    node.remove("tmp");
+  }
+  EXPECT_LT(0, node.CollectGarbage());
+  EXPECT_EQ(0, node.CollectGarbage());
+  EXPECT_EQ(1, node.size());
+  EXPECT_EQ(2, node["list"].size());
+  EXPECT_EQ(50, node["list"][1].as<int>());
+
+  for (int i = 0; i < 10; i++)
+    node["more"].push_back(i);
+  node["list"] = node["more"];
+  EXPECT_EQ(10, node["list"].size());
+  EXPECT_LT(0, node.CollectGarbage());
+  EXPECT_EQ(0, node.CollectGarbage());
+  EXPECT_EQ(9, node["more"][9].as<int>());
+}
+
+TEST(NodeTest, CloneShared) {
+  Node copy;
+  {
+    Node base;
+    base["name"] = "base";
+    base["list"].push_back(1);
+    base["list"].push_back(2);
+    base["nested"]["a"]["b"] = "c";
+    base.Freeze();
+
+    copy = CloneShared(base);
+    const Node& view = copy;  // reading doesn't copy
+    EXPECT_TRUE(view["name"].is(base["name"]));
+    EXPECT_TRUE(view.begin()->second.is(base["name"]));
+    EXPECT_FALSE(copy.IsFrozen());
+    EXPECT_EQ(3, copy.size());
+    EXPECT_EQ(2, copy["list"].size());
+    EXPECT_EQ("c", copy["nested"]["a"]["b"].as<std::string>());
+
+    copy["name"] = "copy";
+    copy["list"].push_back(3);
+    copy["nested"]["a"]["d"] = "e";
+    EXPECT_EQ("base", base["name"].as<std::string>());
+    EXPECT_EQ(2, base["list"].size());
+    EXPECT_FALSE(base["nested"]["a"]["d"]);
+  }
+
+  EXPECT_EQ("copy", copy["name"].as<std::string>());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), copy["list"].as<std::vector<int> >());
+  EXPECT_EQ("e", copy["nested"]["a"]["d"].as<std::string>());
+
+  copy.Freeze();
+  Node copy2 = CloneShared(copy);
+  copy2["list"][0] = 5;
+  EXPECT_EQ(1, copy["list"][0].as<int>());
+  EXPECT_EQ(5, copy2["list"][0].as<int>());
+  EXPECT_EQ(3, copy2["list"].size());
+}
+
+TEST(NodeTest, EqualsAndHash) {
+  Node lhs = Loader().Load("{a: [1, 2], b: {c: d}, e: !t x}");
+  Node rhs;
+  rhs["b"]["c"] = "d";
+  rhs["e"] = "x";
+  rhs["e"].SetTag("!t");
+  rhs["a"].push_back(1);
+  rhs["a"].push_back(2);
+
+  EXPECT_FALSE(lhs == rhs);
+  EXPECT_TRUE(Equals(lhs, rhs));
+  EXPECT_EQ(Hash(lhs), Hash(rhs));
+  EXPECT_EQ(std::hash<Node>()(lhs), Hash(lhs));
+
+  rhs["a"][1] = 3;
+  EXPECT_FALSE(Equals(lhs, rhs));
+  rhs["a"][1] = 2;
+  EXPECT_TRUE(Equals(lhs, rhs));
+  rhs["e"].SetTag("!u");
+  EXPECT_FALSE(Equals(lhs, rhs));
+  EXPECT_FALSE(Equals(lhs["a"], lhs["b"]));
+  EXPECT_TRUE(Equals(lhs["x"], rhs["y"]));
+}
+
+TEST(NodeTest, HashFollowsChanges) {
+  Node shared = Loader().Load("[1, 2]");
+  Node lhs, rhs;
+  lhs["a"]["b"] = shared;
+  rhs["c"] = shared;  // the same node, in two documents
+  const std::size_t lhsHash = Hash(lhs), rhsHash = Hash(rhs);
+
+  // a change deep down is seen all the way up, in both
+  shared.push_back(3);
+  EXPECT_NE(lhsHash, Hash(lhs));
+  EXPECT_NE(rhsHash, Hash(rhs));
+  EXPECT_EQ(Hash(Loader().Load("{a: {b: [1, 2, 3]}}")), Hash(lhs));
+
+  // as is one that replaces a node
+  lhs["a"]["b"] = Node("x");
+  EXPECT_EQ(Hash(Loader().Load("{a: {b: x}}")), Hash(lhs));
+  EXPECT_EQ(Hash(Loader().Load("{c: [1, 2, 3]}")), Hash(rhs));
+
+  // and one to a copy that still shares its elements' cached hashes
+  Node base = Loader().Load("{a: {b: [1, 2]}}");
+  base.Freeze();
+  Node copy = CloneShared(base);
+  copy["a"];  // copies the top level only
+  EXPECT_EQ(Hash(base), Hash(copy));
+  copy["a"]["b"][0] = 5;
+  EXPECT_EQ(Hash(Loader().Load("{a: {b: [5, 2]}}")), Hash(copy));
+  EXPECT_EQ(Hash(Loader().Load("{a: {b: [1, 2]}}")), Hash(base));
+}
+
+TEST(NodeTest, Diff) {
+  Node from = Loader().Load("{a: 1, b: [1, 2, 3], c: {d: e}, f: g}");
+  Node to = Loader().Load("{a: 2, b: [1, 5], c: {d: e}, h: i}");
+  std::vector<NodeChange> changes = Diff(from, to);
+
+  std::vector<std::string> found;
+  for (std::size_t i = 0; i < changes.size(); i++) {
+    std::string path;
+    for (std::size_t j = 0; j < changes[i].path.size(); j++)
+      path += "/" + changes[i].path[j].Scalar();
+    const char* types[] = {"added ", "removed ", "changed "};
+    found.push_back(types[changes[i].type] + path);
+  }
+  EXPECT_EQ((std::vector<std::string>{"changed /a", "changed /b/1",
+                                      "removed /b/2", "removed /f",
+                                      "added /h"}),
+            found);
+  EXPECT_EQ(3, changes[2].from.as<int>());
+  EXPECT_FALSE(changes[2].to.IsDefined());
+  EXPECT_TRUE(Diff(from, Clone(from)).empty());
+}
+
+TEST(NodeTest, MoveNodesAndStrings) {
+  Node child;
+  child["a"] = 1;
+  Node moved(std::move(child));
+  EXPECT_EQ(1, moved["a"].as<int>());
+  EXPECT_TRUE(child.IsNull());
+
+  Node node;
+  node["x"] = std::move(moved);
+  EXPECT_EQ(1, node["x"]["a"].as<int>());
+  EXPECT_TRUE(moved.IsNull());
+
+  // a moved string's buffer becomes the scalar
+  std::string text(100, 'a');
+  const char* data = text.data();
+  Node seq;
+  seq.push_back(std::move(text));
+  EXPECT_EQ(data, seq[0].Scalar().data());
+
+  std::string key(100, 'k'), value(100, 'v');
+  const char* keyData = key.data();
+  const char* valueData = value.data();
+  node.force_insert(std::move(key), std::move(value));
+  for (const_iterator it = node.begin(); it != node.end(); ++it) {
+    if (it->first.Scalar()[0] == 'k') {
+      EXPECT_EQ(keyData, it->first.Scalar().data());
+      EXPECT_EQ(valueData, it->second.Scalar().data());
+    }
+  }
+}
+
+TEST(NodeTest, Emplace) {
+  Node node;
+  EXPECT_TRUE(node.emplace("a", 1));
+  EXPECT_FALSE(node.emplace("a", 2));
+  EXPECT_TRUE(node.emplace(std::string("b"), Node("c")));
+  EXPECT_EQ(1, node["a"].as<int>());
+  EXPECT_EQ("c", node["b"].as<std::string>());
+  EXPECT_EQ(2, node.size());
+
+  Node scalar("text");
+  EXPECT_THROW(scalar.emplace("a", 1), BadInsert);
+  node.Freeze();
+  EXPECT_THROW(node.emplace("a", 1), FrozenNode);
+}
+
 TEST(NodeTest, DefaultNodeStyle) {
   Node node;
   EXPECT_EQ(EmitterStyle::Default, node.Style());
@@ -107,8 +107,9 @@ int main() {
     root = "scalar";  // 'two' is still "two", even though 'root' is "scalar"
                       // (the sequence effectively no longer exists)
 
-    // Note: in all likelihood, the memory for nodes "zero" and "one" is still
-    // allocated. How can it go away? Weak pointers?
+    // Note: the memory for nodes "zero" and "one" is still allocated, until
+    // root.CollectGarbage() frees it (which would free "two" as well, since
+    // 'root' can't reach it).
   }
 
   {